@@ -0,0 +1,38 @@
+# allocation scalability: each task builds and drops many small objects,
+# so the garbage collector has to keep up with all threads at once.
+#
+# compile with --parallel and compare a varying number of threads:
+#
+#   for n in 1 2 4 8; do SHEDSKIN_THREADS=$n ./gcscale; done
+
+import time
+
+
+class Node:
+    def __init__(self, value, next):
+        self.value = value
+        self.next = next
+
+
+def churn(seed):
+    total = 0
+    for r in range(50):
+        head = None
+        for i in range(1000):
+            head = Node(i ^ seed, head)
+        while head is not None:
+            total += head.value & 7
+            head = head.next
+    return total
+
+
+def main():
+    tasks = 256
+    t0 = time.time()
+    results = [churn(seed) for seed in range(tasks)]
+    elapsed = time.time() - t0
+    print(sum(results))
+    print('%.1f million allocations per second' % (tasks * 50 * 1000 / elapsed / 1e6))
+
+
+main()
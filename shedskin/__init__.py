@@ -111,6 +111,9 @@ class Shedskin:
             if args.nogc:
                 gx.nogc = True
 
+            if args.parallel:
+                gx.parallel = True
+
             if args.nowrap:
                 gx.wrap_around_check = False
 
@@ -121,12 +124,27 @@ class Shedskin:
                 gx.assertions = False
 
             if args.subcmd == 'translate':
+                if args.nogil:
+                    gx.nogil = True
+
+                if args.proxy:
+                    gx.proxy = True
+
+                if args.stats:
+                    gx.stats = True
+
+                if args.batch:
+                    gx.batch = True
+
                 if args.nomakefile:
                     gx.nomakefile = True
 
                 if args.makefile:
                     gx.makefile_name = args.makefile
 
+                if args.layout:
+                    gx.layout_report = True
+
                 if args.flags:
                     if not os.path.isfile(args.flags):
                         self.log.error("no such file: '%s'", args.flags)
@@ -169,6 +187,9 @@ class Shedskin:
         infer.analyze(self.gx, self.module_name)
         cpp.generate_code(self.gx)
         error.print_errors()
+        if self.gx.layout_report:
+            for line in cpp.layout_report(self.gx):
+                self.log.info(line)
         self.log.info('\n[elapsed time: %.2f seconds]', (time.time() - t0))
 
     def build(self):
@@ -241,12 +262,18 @@ class Shedskin:
         opt("--int128",             help="Use 128-bit integers", action="store_true")
         opt("--float32",            help="Use 32-bit floats", action="store_true")
         opt("--float64",            help="Use 64-bit floats", action="store_true")
+        opt("--batch",              help="Export <name>_many batch variants of functions with scalar arguments", action="store_true")
+        opt("--layout",             help="Report instance sizes of classes", action="store_true")
 
         opt("--noassert",           help="Disable assert statements", action="store_true")
         opt("-b", "--nobounds",     help="Disable bounds checking", action="store_true")
         opt("--nogc",               help="Disable garbage collection", action="store_true")
+        opt("--nogil",              help="Release the GIL during calls into an extension module", action="store_true")
         opt("--nomakefile",         help="Disable makefile generation", action="store_true")
         opt("-w", "--nowrap",             help="Disable wrap-around checking", action="store_true")
+        opt("--parallel",           help="Run independent comprehensions and marked loops on a thread pool", action="store_true")
+        opt("--proxy",              help="Return lists, dicts and sets from an extension module as lazy proxies", action="store_true")
+        opt("--stats",              help="Count calls and conversion times in an extension module", action="store_true")
 
         parser_build = subparsers.add_parser('build', help="build translated module")
         arg = opt = parser_build.add_argument
@@ -288,6 +315,7 @@ class Shedskin:
         opt("--nowarnings",         help="Disable '-Wall' compilation warnings", action="store_true")
         opt("--nogc",               help="Disable garbage collection", action="store_true")
         opt("--nowrap",             help="Disable wrap-around checking", action="store_true")
+        opt("--parallel",           help="Run independent comprehensions and marked loops on a thread pool", action="store_true")
 
         parser_run = subparsers.add_parser('run', help="run built and translated module")
         arg = opt = parser_run.add_argument
@@ -329,6 +357,7 @@ class Shedskin:
         opt("--nogc",               help="Disable garbage collection", action="store_true")
         opt("--nowarnings",         help="Disable '-Wall' compilation warnings", action="store_true")
         opt("--nowrap",             help="Disable wrap-around checking", action="store_true")
+        opt("--parallel",           help="Run independent comprehensions and marked loops on a thread pool", action="store_true")
 
         parser_test = subparsers.add_parser('test', help="run tests")
         arg = opt = parser_test.add_argument
@@ -4,6 +4,7 @@ Copyright 2005-2023 Mark Dufour and contributors; License GNU GPL version 3 (See
 
 """
 import ast
+import copy
 
 
 def is_assign_list_or_tuple(node) -> bool:
@@ -66,6 +67,321 @@ def is_zip2(node) -> bool:
         and is_assign_list_or_tuple(node.target)
     )
 
+
+def is_lazysplit(node) -> bool:
+    # literal arguments only, as they are re-evaluated for each element
+    if not (
+        isinstance(node.iter, ast.Call)
+        and isinstance(node.iter.func, ast.Attribute)
+        and node.iter.func.attr in ["split", "splitlines"]
+        and not node.iter.keywords
+    ):
+        return False
+    args = node.iter.args
+    if node.iter.func.attr == "splitlines":
+        return len(args) <= 1 and all(is_literal(arg) for arg in args)
+    return (
+        len(args) <= 2
+        and (
+            not args
+            or isinstance(args[0], ast.Constant)
+            and (args[0].value is None or isinstance(args[0].value, str))
+        )
+        and all(is_literal(arg) for arg in args[1:])
+    )
+
+
+def is_let_binding(node) -> bool:
+    # for x in [expr]: bind without allocating a list
+    return isinstance(node.iter, ast.List) and len(node.iter.elts) == 1
+
+
+# --- side-effect free expressions, used to decide whether comprehensions can be fused
+PURE_BUILTINS = {
+    "abs", "all", "any", "bool", "chr", "divmod", "enumerate", "float", "hash",
+    "int", "len", "list", "max", "min", "ord", "pow", "range", "repr", "reversed",
+    "round", "sorted", "str", "sum", "tuple", "zip",
+}
+PURE_METHODS = {
+    "capitalize", "count", "endswith", "find", "isalnum", "isalpha", "isdigit",
+    "islower", "isspace", "isupper", "join", "lower", "lstrip", "replace",
+    "rfind", "rstrip", "split", "startswith", "strip", "swapcase", "title",
+    "upper", "zfill",
+}
+
+
+def is_pure(node, funcs, methods, busy=()) -> bool:
+    # funcs: module-level ast.FunctionDef by name; methods: names of user-defined methods
+    for child in ast.walk(node):
+        if isinstance(child, (ast.Global, ast.Nonlocal, ast.Yield, ast.YieldFrom, ast.NamedExpr, ast.Await)):
+            return False
+        if isinstance(child, (ast.Attribute, ast.Subscript)) and not isinstance(child.ctx, ast.Load):
+            return False
+        if isinstance(child, ast.Call):
+            if isinstance(child.func, ast.Attribute):
+                if child.func.attr not in PURE_METHODS or child.func.attr in methods:
+                    return False
+            elif not isinstance(child.func, ast.Name):
+                return False
+            elif child.func.id in funcs:
+                if child.func.id not in busy and not is_pure(
+                    funcs[child.func.id], funcs, methods, busy + (child.func.id,)
+                ):
+                    return False
+            elif child.func.id not in PURE_BUILTINS:
+                return False
+    return True
+
+
+def bound_names(node) -> set:
+    return {n.id for n in ast.walk(node) if isinstance(n, ast.Name) and isinstance(n.ctx, ast.Store)}
+
+
+def used_names(node, skip=None) -> set:
+    names = set()
+    todo = [node]
+    while todo:
+        child = todo.pop()
+        if child is not skip:
+            if isinstance(child, ast.Name):
+                names.add(child.id)
+            todo.extend(ast.iter_child_nodes(child))
+    return names
+
+
+def fuse_comprehension(node, funcs, methods):
+    # [f(x) for x in [g(y) for y in ys]] -> [f(x) for y in ys for x in [g(y)]]
+    # (the latter is compiled as a binding, so no intermediate list is built)
+    for i, qual in enumerate(node.generators):
+        inner = qual.iter
+        if not isinstance(inner, (ast.ListComp, ast.GeneratorExp)):
+            continue
+        inner_names = set()
+        for inner_qual in inner.generators:
+            inner_names |= bound_names(inner_qual.target)
+        outer_names = set()
+        for outer_qual in node.generators:
+            outer_names |= bound_names(outer_qual.target)
+        if inner_names & used_names(node, skip=inner) or outer_names & used_names(inner):
+            continue
+        # a list is built eagerly, so with side effects on both sides fusion would reorder them;
+        # a generator is consumed lazily, which is exactly what fusion does
+        if isinstance(inner, ast.ListComp):
+            inner_parts = [inner.elt] + inner.generators[0].ifs + inner.generators[1:]
+            outer_parts = [node.elt] + qual.ifs + node.generators[i + 1:]
+            if not all(is_pure(part, funcs, methods) for part in inner_parts + outer_parts):
+                continue
+        binding = ast.comprehension(
+            qual.target, ast.List([inner.elt], ast.Load()), qual.ifs, 0
+        )
+        ast.copy_location(binding.iter, inner)
+        node.generators[i:i + 1] = list(inner.generators) + [binding]
+        fuse_comprehension(node, funcs, methods)
+        return
+
+
+def has_loop_exit(stmts) -> bool:
+    # break/continue that applies to the enclosing loop
+    todo = list(stmts)
+    while todo:
+        child = todo.pop()
+        if isinstance(child, (ast.Break, ast.Continue)):
+            return True
+        if isinstance(child, (ast.For, ast.While)):
+            todo.extend(child.orelse)
+        elif not isinstance(child, (ast.FunctionDef, ast.ClassDef, ast.Lambda)):
+            todo.extend(ast.iter_child_nodes(child))
+    return False
+
+
+def has_nested_scope(node) -> bool:
+    return any(
+        isinstance(child, (ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef, ast.Lambda,
+                           ast.ListComp, ast.SetComp, ast.DictComp, ast.GeneratorExp))
+        for child in ast.walk(node) if child is not node
+    )
+
+
+def is_inline_generator(node) -> bool:
+    # straight-line generator: yield statements only, no return, try or nested scopes
+    args = node.args
+    if (
+        node.decorator_list
+        or args.vararg or args.kwarg or args.kwonlyargs or args.posonlyargs
+        or not all(isinstance(default, ast.Constant) for default in args.defaults)
+        or has_nested_scope(node)
+    ):
+        return False
+    yields = 0
+    for child in ast.walk(node):
+        if isinstance(child, (ast.Return, ast.Try, ast.With, ast.Global, ast.Nonlocal,
+                              ast.YieldFrom, ast.Await, ast.NamedExpr)):
+            return False
+        if isinstance(child, ast.Name) and child.id == node.name:  # recursive
+            return False
+        if isinstance(child, ast.Expr) and isinstance(child.value, ast.Yield):
+            yields += 1
+    return 1 <= yields <= 2 and yields == len([child for child in ast.walk(node) if isinstance(child, ast.Yield)])
+
+
+def rename(node, names):
+    for child in ast.walk(node):
+        if isinstance(child, ast.Name) and child.id in names:
+            child.id = names[child.id]
+    return node
+
+
+class GeneratorInliner:
+    """
+    replace for-loops over generator expressions and simple generator functions
+    by plain loops, so no generator objects are created:
+
+    for x in gen(a):         __gen1_n = a
+        body                 <gen body, with 'yield e' replaced by 'x = e; body'>
+    """
+
+    def __init__(self, tree):
+        self.count = 0
+        self.gens = {}
+        self.done = set()
+        for node in tree.body:
+            if isinstance(node, ast.FunctionDef) and [child for child in ast.walk(node) if isinstance(child, ast.Yield)]:
+                node.body = self.stmts(node.body, node, {node.name})
+                self.done.add(node)
+                if is_inline_generator(node):
+                    self.gens[node.name] = node
+        tree.body = self.stmts(tree.body, None, set())
+        ast.fix_missing_locations(tree)
+
+    def stmts(self, stmts, scope, active):
+        result = []
+        for stmt in stmts:
+            if isinstance(stmt, (ast.FunctionDef, ast.AsyncFunctionDef)):
+                if stmt not in self.done:
+                    stmt.body = self.stmts(stmt.body, stmt, set())
+                result.append(stmt)
+                continue
+            if isinstance(stmt, ast.ClassDef):
+                scope2 = stmt
+            else:
+                scope2 = scope
+            for field in ("body", "orelse", "finalbody", "handlers"):
+                value = getattr(stmt, field, None)
+                if field == "handlers" and value:
+                    for handler in value:
+                        handler.body = self.stmts(handler.body, scope2, active)
+                elif value and isinstance(value[0], ast.stmt):
+                    setattr(stmt, field, self.stmts(value, scope2, active))
+            inlined = None
+            if isinstance(stmt, ast.For) and not isinstance(scope, ast.ClassDef):
+                inlined = self.inline_genexpr(stmt, scope, active) or self.inline_call(stmt, scope, active)
+            if inlined:
+                result.extend(inlined)
+            else:
+                result.append(stmt)
+        return result
+
+    def local_names(self, scope):
+        if scope is None:
+            return set()
+        return bound_names(scope) | {arg.arg for arg in ast.walk(scope.args) if isinstance(arg, ast.arg)}
+
+    def inline_genexpr(self, node, scope, active):
+        genexpr = node.iter
+        if not isinstance(genexpr, ast.GeneratorExp) or has_nested_scope(genexpr):
+            return None
+        if len(genexpr.generators) > 1 and has_loop_exit(node.body):
+            return None
+        if any(qual.is_async for qual in genexpr.generators):
+            return None
+
+        # loop variables no longer live in their own scope
+        self.count += 1
+        names = {}
+        for qual in genexpr.generators:
+            for name in sorted(bound_names(qual.target)):
+                names[name] = "__genexpr%d_%s" % (self.count, name)
+
+        body = [ast.copy_location(ast.Assign([node.target], rename(genexpr.elt, names)), node)] + node.body
+        for qual in reversed(genexpr.generators):
+            qual.ifs = [rename(cond, names) for cond in qual.ifs]
+            if qual.ifs:
+                if len(qual.ifs) == 1:
+                    test = qual.ifs[0]
+                else:
+                    test = ast.BoolOp(ast.And(), qual.ifs)
+                body = [ast.copy_location(ast.If(test, body, []), node)]
+            if qual is not genexpr.generators[0]:
+                qual.iter = rename(qual.iter, names)
+            body = [ast.copy_location(ast.For(rename(qual.target, names), qual.iter, body, []), node)]
+
+        loop = body[0]
+        if len(genexpr.generators) == 1:
+            loop.orelse = node.orelse
+            return self.stmts([loop], scope, active)
+        return self.stmts([loop], scope, active) + node.orelse
+
+    def inline_call(self, node, scope, active):
+        call = node.iter
+        if not (
+            isinstance(call, ast.Call)
+            and isinstance(call.func, ast.Name)
+            and call.func.id in self.gens
+            and call.func.id not in active
+            and not call.keywords
+            and not [arg for arg in call.args if isinstance(arg, ast.Starred)]
+            and not has_loop_exit(node.body)
+        ):
+            return None
+        gen = self.gens[call.func.id]
+        params = [arg.arg for arg in gen.args.args]
+        defaults = gen.args.defaults
+        if len(call.args) > len(params) or len(call.args) + len(defaults) < len(params):
+            return None
+
+        # free names of the generator must mean the same in the caller
+        names = set(params) | bound_names(gen)
+        free = used_names(gen) - names
+        if free & self.local_names(scope) or call.func.id in self.local_names(scope):
+            return None
+
+        self.count += 1
+        names = {name: "__%s%d_%s" % (gen.name, self.count, name) for name in sorted(names)}
+
+        result = []
+        args = call.args + defaults[len(defaults) - (len(params) - len(call.args)):] if len(params) > len(call.args) else call.args
+        for param, arg in zip(params, args):
+            if arg in defaults:
+                arg = copy.deepcopy(arg)
+            result.append(ast.copy_location(ast.Assign([ast.Name(names[param], ast.Store())], arg), node))
+
+        body = rename(copy.deepcopy(gen), names).body
+        first = [True]
+
+        def expand(stmts):
+            new = []
+            for stmt in stmts:
+                if isinstance(stmt, ast.Expr) and isinstance(stmt.value, ast.Yield):
+                    value = stmt.value.value or ast.Constant(None)
+                    if first[0]:
+                        target, loop_body = node.target, node.body
+                        first[0] = False
+                    else:
+                        target, loop_body = copy.deepcopy(node.target), copy.deepcopy(node.body)
+                    new.append(ast.copy_location(ast.Assign([target], value), stmt))
+                    new.extend(loop_body)
+                    continue
+                for field in ("body", "orelse"):
+                    value = getattr(stmt, field, None)
+                    if value and isinstance(value[0], ast.stmt):
+                        setattr(stmt, field, expand(value))
+                new.append(stmt)
+            return new
+
+        result.extend(self.stmts(expand(body), scope, active | {gen.name}))
+        return result + node.orelse
+
+
 # --- recursively determine (lvalue, rvalue) pairs in assignment expressions
 def assign_rec(left, right):
     if is_assign_list_or_tuple(left) and isinstance(
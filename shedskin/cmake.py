@@ -27,6 +27,7 @@ import textwrap
 import time
 
 from . import config
+from . import python
 
 from .utils import CYAN, GREEN, RED, RESET, WHITE
 
@@ -530,7 +531,10 @@ def generate_cmakefile(gx: config.GlobalInfo):
         compile_options.append("-D__SS_BACKTRACE -rdynamic -fno-inline")
     if gx.nogc:
         compile_options.append("-D__SS_NOGC")
+    if python.gc_threads(gx):
+        compile_options.append("-pthread -DGC_THREADS")
     compile_opts = ' '.join(compile_options)
+    link_opts = "-pthread" if python.gc_threads(gx) else None
 
     for module in modules:
         if module.builtin and module.filename.is_relative_to(gx.shedskin_lib):
@@ -567,6 +571,7 @@ def generate_cmakefile(gx: config.GlobalInfo):
                 link_libs=gx.options.link_libs,
                 extra_lib_dir=gx.options.extra_lib,
                 compile_options=compile_opts,
+                link_options=link_opts,
             ),
         )
         master_clfile.write_text(master_clfile_content)
@@ -586,6 +591,7 @@ def generate_cmakefile(gx: config.GlobalInfo):
                 link_libs=gx.options.link_libs,
                 extra_lib_dir=gx.options.extra_lib,
                 compile_options=compile_opts,
+                link_options=link_opts,
             )
         )
 
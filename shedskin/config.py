@@ -80,11 +80,17 @@ class GlobalInfo:  # XXX add comments, split up
         self.flags = None
         self.silent: bool = False
         self.nogc: bool = False
+        self.nogil: bool = False
+        self.proxy: bool = False
+        self.stats: bool = False
+        self.batch: bool = False
+        self.parallel: bool = False
         self.backtrace: bool = False
         self.makefile_name: str = "Makefile"
         self.debug_level: int = 0
         self.outputdir: Optional[str] = None
         self.nomakefile: bool = False
+        self.layout_report: bool = False
 
         # Others
         self.item_rvalue = {}
@@ -92,6 +98,7 @@ class GlobalInfo:  # XXX add comments, split up
         self.bool_test_only = set()
         self.tempcount = {}
         self.struct_unpack = {}
+        self.attribute_heat = None
         self.maxhits = 0  # XXX amaze.py termination
         self.terminal = None
         self.progressbar:  Optional['ProgressBar'] = None
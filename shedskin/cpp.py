@@ -15,6 +15,7 @@ dimensions (gx.merged_inh).
 """
 import ast
 import os
+import re
 import string
 import struct
 import textwrap
@@ -110,6 +111,14 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         self.bool_wrapper = {}
         self.namer = CPPNamer(self.gx, self)
         self.extmod = extmod.ExtensionModule(self.gx, self)
+        self.reducing = None
+        self.user_classes = None
+        self.reduction_calls = {}
+        for node in ast.walk(module.ast):
+            if isinstance(node, ast.Call) and len(node.args) == 1 and not node.keywords:
+                arg = self.gx.genexp_to_lc.get(node.args[0], node.args[0])
+                if isinstance(arg, ast.ListComp):
+                    self.reduction_calls[arg] = node
 
     def cpp_name(self, obj):
         return self.namer.name(obj)
@@ -788,7 +797,7 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                     and var in self.gx.merged_inh
                     and self.gx.merged_inh[var]
                 ):
-                    varname = self.cpp_name(var)
+                    varname = self.member_ref(var)
                     if name == "__deepcopy__":
                         self.output("c->%s = __deepcopy(%s);" % (varname, varname))
                     else:
@@ -808,6 +817,14 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
     def class_hpp(self, node):
         cl = self.mv.classes[node.name]
         self.output("extern class_ *cl_" + cl.ident + ";")
+        if "soa" in python.class_directives(cl) and not soa_class(self.gx, cl):
+            error.error(
+                "class with base classes or subclasses cannot use struct-of-arrays layout",
+                self.gx,
+                node,
+                warning=True,
+                mv=self.mv,
+            )
 
         # --- header
         clnames = [self.namer.namespace_class(b) for b in cl.bases]
@@ -943,16 +960,10 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             self.print()
 
         # --- instance variables
-        for var in cl.vars.values():
-            if var.invisible:
-                continue  # var.name in cl.virtualvars: continue
-            # var is masked by ancestor var
-            vars = set()
-            for ancestor in cl.ancestors():
-                vars.update(ancestor.vars)
-            if var.name in vars:
-                continue
-            if var in self.gx.merged_inh and self.gx.merged_inh[var]:
+        if soa_class(self.gx, cl):
+            self.soa_variables(cl)
+        else:
+            for var in instance_variables(self.gx, cl):
                 self.output(
                     typestr.nodetypestr(self.gx, var, cl, mv=self.mv)
                     + self.cpp_name(var)
@@ -962,6 +973,29 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         if [v for v in cl.vars if not v.startswith("__")]:
             self.print()
 
+    def soa_variables(self, cl):
+        """instance variables stored as struct of arrays: accessors for per-attribute
+        arrays, indexed by the position of the object within its chunk"""
+        ivars = instance_variables(self.gx, cl)
+        types = [typestr.nodetypestr(self.gx, var, cl, mv=self.mv) for var in ivars]
+        self.output(
+            "typedef __ss_soa<%s%s> __ss_layout;"
+            % (self.cpp_name(cl), "".join(", sizeof(%s)" % ts.strip() for ts in types))
+        )
+        self.output("static void *operator new(size_t) { return __ss_layout::alloc(); }")
+        self.output("static void operator delete(void *) {}")
+        for i, (var, ts) in enumerate(zip(ivars, types)):
+            self.output(
+                "%s&%s() { return __ss_layout::field<%s, %d>(this); }"
+                % (ts, self.cpp_name(var), ts.strip(), i)
+            )
+
+    def member_ref(self, var):
+        """instance variable var, as accessed through its object"""
+        if isinstance(var.parent, python.Class) and soa_class(self.gx, var.parent):
+            return self.cpp_name(var) + "()"
+        return self.cpp_name(var)
+
     def nothing(self, types):
         if python.def_class(self.gx, "complex") in (t[0] for t in types):
             return "mcomplex(0.0, 0.0)"
@@ -1163,6 +1197,10 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         self.visit_TryExcept(node, func)
 
     def visit_TryExcept(self, node, func=None):
+        if self.try_lookup(node, func):
+            self.do_try_lookup(node, func)
+            return
+
         # try
         self.start("try {")
         self.print(self.line)
@@ -1237,6 +1275,85 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             self.deindent()
             self.output("}")
 
+    def try_lookup(self, node, func):
+        """try: x = d[k] (or l[i], int(s)) except KeyError (IndexError, ValueError): lower to a non-throwing lookup"""
+        if len(node.body) != 1 or len(node.handlers) != 1 or node.finalbody:
+            return None
+        stmt, handler = node.body[0], node.handlers[0]
+        if not (
+            isinstance(stmt, ast.Assign)
+            and len(stmt.targets) == 1
+            and isinstance(stmt.targets[0], ast.Name)
+            and isinstance(handler.type, ast.Name)
+            and not handler.name
+        ):
+            return None
+        cl = python.lookup_class(handler.type, self.mv)
+        if not cl or not cl.mv.module.builtin:
+            return None
+
+        value = stmt.value
+        if isinstance(value, ast.Subscript) and not isinstance(value.slice, ast.Slice):
+            if not (self.simple_operand(value.value) and self.simple_operand(value.slice)):
+                return None
+            if self.only_classes(value.value, ("dict",)) and not self.user_typed(value.slice):
+                kind, excs = "dict", ("KeyError", "LookupError")
+            elif self.only_classes(value.value, ("list",)) and self.only_classes(
+                value.slice, ("int_",)
+            ):
+                kind, excs = "list", ("IndexError", "LookupError")
+            else:
+                return None
+        elif (
+            isinstance(value, ast.Call)
+            and isinstance(value.func, ast.Name)
+            and value.func.id == "int"
+            and len(value.args) == 1
+            and not value.keywords
+            and self.simple_operand(value.args[0])
+            and self.only_classes(value.args[0], ("str_",))
+            and self.only_classes(
+                python.lookup_var(stmt.targets[0].id, func, mv=self.mv), ("int_",)
+            )
+        ):
+            kind, excs = "int", ("ValueError",)
+        else:
+            return None
+
+        if cl.ident not in excs:
+            return None
+        return kind
+
+    def simple_operand(self, node):
+        # evaluating a name, attribute, constant or tuple of these cannot raise by itself
+        return all(
+            isinstance(child, (ast.Name, ast.Attribute, ast.Constant, ast.Tuple, ast.Load))
+            for child in ast.walk(node)
+        )
+
+    def do_try_lookup(self, node, func):
+        stmt, handler = node.body[0], node.handlers[0]
+        target = self.cpp_name(stmt.targets[0].id)
+        value = stmt.value
+        self.start("if (!")
+        if isinstance(value, ast.Call):
+            self.visitm("__int_parse(", value.args[0], ", " + target + ")", func)
+        else:
+            self.visitm(value.value, "->__lookup__(", value.slice, ", " + target + ")", func)
+        self.append(") {")
+        self.print(self.line)
+        self.indent()
+        for child in handler.body:
+            self.visit(child, func)
+        self.deindent()
+        if node.orelse:
+            self.output("} else {")
+            self.indent()
+            for child in node.orelse:
+                self.visit(child, func)
+            self.deindent()
+        self.output("}")
+
     def do_fastfor(self, node, qual, quals, iter, func, genexpr):
         if len(qual.iter.args) == 3 and not ast_utils.is_literal(qual.iter.args[2]):
             for arg in qual.iter.args:  # XXX simplify
@@ -1247,6 +1364,107 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         self.fastfor(qual, iter, func)
         self.forbody(node, quals, iter, func, False, genexpr)
 
+    def parallel_for(self, node, func):
+        # for i in range(..):  # shedskin: parallel (with --parallel)
+        if not self.gx.parallel or "parallel" not in python.directives(self.mv, node):
+            return None
+        parallel = infer.parallel_loop(self.gx, node, func)
+        if parallel is None:
+            error.error("loop cannot run in parallel", self.gx, node, warning=True, mv=self.mv)
+        return parallel
+
+    def parallel_private(self, func):
+        # locals that only parallel loops use, so that each thread declares them instead
+        loops, nodes = [], [func.node]
+        while nodes:
+            node = nodes.pop()
+            if (
+                isinstance(node, ast.For)
+                and ast_utils.is_fastfor(node)
+                and self.gx.parallel
+                and "parallel" in python.directives(self.mv, node)
+            ):
+                parallel = infer.parallel_loop(self.gx, node, func)
+                if parallel:
+                    loops.append((node, parallel[1]))
+                    continue
+            for child in ast.iter_child_nodes(node):
+                if not isinstance(child, (ast.FunctionDef, ast.ClassDef, ast.Lambda)):
+                    nodes.append(child)
+        private = set()
+        inside = set()
+        for node, names in loops:
+            private |= names | self.temps_in(node)
+            for arg in node.iter.args:  # evaluated outside the threads
+                private -= self.temps_in(arg)
+            inside.update(ast.walk(node))
+        for node in ast.walk(func.node):
+            if isinstance(node, ast.Name) and node not in inside:
+                private.discard(node.id)
+        return private
+
+    def do_parallel_for(self, node, func, assname, reductions, private):
+        args = node.iter.args
+        self.output("{")
+        self.indent()
+        self.start("__ss_int __ss_start = ")
+        if len(args) == 1:
+            self.append("0")
+        else:
+            self.visit(args[0], func)
+        self.append(", __ss_stop = ")
+        self.visit(args[0] if len(args) == 1 else args[1], func)
+        self.append(", __ss_step = ")
+        if len(args) == 3:
+            self.visit(args[2], func)
+        else:
+            self.append("1")
+        self.eol()
+        self.output("if (__ss_step == 0)")
+        self.output("    __throw_range_step_zero();")
+        self.output("size_t __ss_n = (size_t)__range_len(__ss_start, __ss_stop, __ss_step);")
+        reduce = []
+        for name, op in reductions.items():
+            var = python.lookup_var(name, func, mv=self.mv)
+            reduce.append((typestr.nodetypestr(self.gx, var, func, mv=self.mv).strip(), self.cpp_name(var), op))
+        for typ, name, op in reduce:
+            self.output("__ss_reduction<%s> __ss_red_%s;" % (typ, name))
+        self.output("__ss_parallel_run(__ss_n, [&](size_t __ss_lo, size_t __ss_hi) {")
+        self.indent()
+
+        # private to each thread, including temporaries for the body
+        temps = set()
+        for child in node.body:
+            temps |= self.temps_in(child)
+        pairs = []
+        for name, var in func.vars.items():
+            if not var.invisible and name not in func.formals and name not in reductions and (
+                name in private or name in temps
+            ):
+                pairs.append((typestr.nodetypestr(self.gx, var, func, mv=self.mv), self.cpp_name(var)))
+        if pairs:
+            self.output(self.indentation.join(self.group_declarations(pairs)))
+        for typ, name, op in reduce:
+            self.output("%s %s = %s;" % (typ, name, "0" if op == "+" else "1"))
+
+        self.output("for(size_t __ss_i = __ss_lo; __ss_i < __ss_hi; __ss_i++) {")
+        self.indent()
+        self.output("%s = __ss_start + (__ss_int)__ss_i * __ss_step;" % assname)
+        self.gx.loopstack.append(node)
+        for child in node.body:
+            self.visit(child, func)
+        self.gx.loopstack.pop()
+        self.deindent()
+        self.output("}")
+        for typ, name, op in reduce:
+            self.output("__ss_red_%s.add(__ss_lo, %s);" % (name, name))
+        self.deindent()
+        self.output("});")
+        for typ, name, op in reduce:
+            self.output("%s = __ss_red_%s.%s(%s);" % (name, name, "sum" if op == "+" else "product", name))
+        self.deindent()
+        self.output("}")
+
     def impl_visit_temp(self, node, func):  # XXX generalize?
         if node in self.mv.tempcount:
             self.append(self.mv.tempcount[node])
@@ -1297,6 +1515,11 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             and node.iter.func.attr == "items"
         )
 
+    def lazysplit(self, node):
+        return ast_utils.is_lazysplit(node) and self.only_classes(
+            node.iter.func.value, ("str_",)
+        )
+
     def only_classes(self, node, names):
         if node not in self.mergeinh:
             return False
@@ -1319,7 +1542,11 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         if node.orelse:
             self.output("%s = 0;" % self.mv.tempcount[node.orelse[0]])
         if ast_utils.is_fastfor(node):
-            self.do_fastfor(node, node, None, assname, func, False)
+            parallel = self.parallel_for(node, func)
+            if parallel:
+                self.do_parallel_for(node, func, assname, *parallel)
+            else:
+                self.do_fastfor(node, node, None, assname, func, False)
         elif self.fastenumerate(node):
             self.do_fastenumerate(node, func, False)
             self.forbody(node, None, assname, func, True, False)
@@ -1329,8 +1556,11 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         elif self.fastdictiter(node):
             self.do_fastdictiter(node, func, False)
             self.forbody(node, None, assname, func, True, False)
+        elif self.lazysplit(node):
+            self.do_lazysplit(node, assname, func)
+            self.forbody(node, None, assname, func, False, False)
         else:
-            pref, tail = self.forin_preftail(node)
+            pref, tail = self.forin_preftail(node, node.body, func)
             self.start("FOR_IN%s(%s," % (pref, assname))
             self.visit(node.iter, func)
             self.print(self.line + "," + tail + ")")
@@ -1421,10 +1651,141 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         if ast_utils.is_assign_list_or_tuple(right):
             self.tuple_assign(right, self.mv.tempcount[right], func)
 
-    def forin_preftail(self, node):
+    def do_lazysplit(self, node, assname, func):
+        args = node.iter.args
+        if node.iter.func.attr == "split":
+            self.start("FOR_IN_SPLIT(%s," % assname)
+            self.visit(node.iter.func.value, func)
+            if args and not (isinstance(args[0], ast.Constant) and args[0].value is None):
+                self.visitm(",", args[0], func)
+            else:
+                self.append(",NULL")
+            if len(args) == 2:
+                self.visitm(",", args[1], func)
+            else:
+                self.append(",-1")
+            tail = self.mv.tempcount[node, 7][2:] + "," + self.mv.tempcount[node, 5][2:]
+            tail += "," + self.mv.tempcount[node.iter][2:]
+        else:
+            self.start("FOR_IN_SPLITLINES(%s," % assname)
+            self.visit(node.iter.func.value, func)
+            if args:
+                self.visitm(",", args[0], func)
+            else:
+                self.append(",0")
+            tail = self.mv.tempcount[node, 7][2:] + "," + self.mv.tempcount[node, 5][2:]
+        self.print(self.line + "," + tail + ")")
+
+    def forin_preftail(self, node, body=(), func=None, genexpr=False):
         tail = self.mv.tempcount[node][2:] + "," + self.mv.tempcount[node.iter][2:]
         tail += "," + self.mv.tempcount[(node, 5)][2:]
-        return "", tail
+        return self.forin_seq(node, body, func, genexpr), tail
+
+    def forin_seq(self, node, body, func, genexpr):
+        """iterate directly over the underlying buffer, with the end condition hoisted"""
+        if (func and func.isGenerator) or genexpr:  # yield would jump into the loop
+            return ""
+        if self.only_classes(node.iter, ("str_",)):
+            return "_STR"
+        if self.only_classes(node.iter, ("tuple", "tuple2")) and typestr.nodetypestr(
+            self.gx, node.iter, None, mv=self.mv
+        ).startswith("tuple<"):
+            return "_SEQ"
+        if self.only_classes(node.iter, ("list",)) and self.cannot_resize(node.iter, body):
+            return "_SEQ"
+        if self.only_classes(node.iter, ("bytes_",)) and self.cannot_resize(node.iter, body):
+            return "_BYTES"
+        return ""
+
+    def user_typed(self, node):
+        if isinstance(node, ast.Constant):
+            return False
+        if node not in self.mergeinh:
+            return True
+        if [t for t in self.mergeinh[node] if isinstance(t[0], python.Function)]:
+            return True
+        if self.user_classes is None:
+            self.user_classes = set()
+            for module in self.gx.modules.values():
+                if not module.builtin:
+                    self.user_classes.update(cl.ident for cl in module.mv.classes.values())
+        ts = typestr.nodetypestr(self.gx, node, None, mv=self.mv)
+        return bool(self.user_classes & set(re.findall(r"\w+", ts)))
+
+    def cannot_resize(self, seq, body):
+        # conservative: any call into user code, or any builtin operation that may
+        # touch a sequence of the same type, or user-defined operators, disqualify
+        seqtype = typestr.nodetypestr(self.gx, seq, None, mv=self.mv)
+
+        def same_type(node):
+            return not isinstance(node, ast.Constant) and (
+                node not in self.mergeinh
+                or typestr.nodetypestr(self.gx, node, None, mv=self.mv) == seqtype
+            )
+
+        for node in body:
+            for child in ast.walk(node):
+                if isinstance(
+                    child,
+                    (
+                        ast.Yield,
+                        ast.YieldFrom,
+                        ast.Lambda,
+                        ast.FunctionDef,
+                        ast.ClassDef,
+                        ast.With,
+                        ast.Delete,
+                        ast.Global,
+                    ),
+                ):
+                    return False
+                elif isinstance(child, ast.Call):
+                    funcs = infer.callfunc_targets(self.gx, child, self.mergeinh)
+                    if [f for f in funcs if not f.mv.module.builtin]:
+                        return False
+                    if not funcs:
+                        constructor = infer.analyze_callfunc(
+                            self.gx, child, merge=self.mergeinh
+                        )[4]
+                        if not constructor or not constructor.mv.module.builtin:
+                            return False
+                    args = list(child.args) + [kw.value for kw in child.keywords]
+                    if isinstance(child.func, ast.Attribute):
+                        args.append(child.func.value)
+                    pure = funcs and all(
+                        f.ident in ast_utils.PURE_METHODS | {"index"}
+                        if f.parent
+                        else f.ident in ast_utils.PURE_BUILTINS and f.mv.module.ident == "builtin"
+                        for f in funcs
+                    )
+                    for arg in args:
+                        if (same_type(arg) and not pure) or self.user_typed(arg):
+                            return False
+                elif isinstance(child, ast.BinOp):
+                    if [o for o in (child.left, child.right) if same_type(o) or self.user_typed(o)]:
+                        return False
+                elif isinstance(child, ast.BoolOp):
+                    if [o for o in child.values if self.user_typed(o)]:
+                        return False
+                elif isinstance(child, ast.UnaryOp):
+                    if self.user_typed(child.operand):
+                        return False
+                elif isinstance(child, ast.Compare):
+                    if [op for op in child.ops if not isinstance(op, (ast.Is, ast.IsNot))] and [
+                        o for o in [child.left] + child.comparators if self.user_typed(o)
+                    ]:
+                        return False
+                elif isinstance(child, ast.Subscript):
+                    if self.user_typed(child.value) or (
+                        not isinstance(child.slice, ast.Slice) and self.user_typed(child.slice)
+                    ):
+                        return False
+                    if isinstance(child.ctx, ast.Store) and isinstance(child.slice, ast.Slice) and same_type(child.value):
+                        return False
+                elif isinstance(child, ast.AugAssign):
+                    if not self.cannot_resize(seq, [infer.inode(self.gx, child).assignhop]):
+                        return False
+        return True
 
     def forbody(self, node, quals, iter, func, skip, genexpr):
         if quals is not None:
@@ -1604,7 +1965,8 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             return
 
         # --- local declarations
-        self.local_defs(func)
+        private = self.parallel_private(func)
+        self.local_defs(func, set(func.vars) - private)
 
         # --- function body
         for fake_unpack in func.expand_args.values():
@@ -2129,13 +2491,15 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         argtypes = ltypes | rtypes
         ul, ur = typestr.unboxable(self.gx, ltypes), typestr.unboxable(self.gx, rtypes)
 
-        # expr (not) in [const, ..]/(const, ..)
+        # expr (not) in [const, ..]/(const, ..)/{const, ..}
         if (
             middle == "__contains__"
-            and isinstance(left, (ast.Tuple, ast.List))
+            and isinstance(left, (ast.Tuple, ast.List, ast.Set))
             and left.elts
             and all([isinstance(elt, ast.Constant) for elt in left.elts])
         ):
+            if self.do_compare_literals(left, right, func, prefix):
+                return
             self.append("(")
             for i, elem in enumerate(left.elts):
                 if prefix == "!":
@@ -2159,6 +2523,15 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             self.append(")")
             return
 
+        # expr ==/!= str const
+        if middle in ("__eq__", "__ne__"):
+            if self.is_str_const(right) and self.only_classes(left, ("str_",)):
+                self.do_compare_str_const(left, right, argtypes, middle, func)
+                return
+            if self.is_str_const(left) and self.only_classes(right, ("str_",)):
+                self.do_compare_str_const(right, left, argtypes, middle, func)
+                return
+
         # --- inline other
         if inline and (
             (ul and ur)
@@ -2199,6 +2572,59 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         self.visit2(right, argtypes, middle, func)
         self.append(")" + postfix)
 
+    def is_str_const(self, node):
+        return isinstance(node, ast.Constant) and type(node.value) == str
+
+    def str_const_args(self, value):
+        return '"%s", %d' % (self.expand_special_chars(value), len(value.encode("utf-8")))
+
+    def do_compare_str_const(self, node, const, argtypes, middle, func):
+        if middle == "__ne__":
+            self.append("!")
+        self.append("__eq_lit(")
+        self.visit2(node, argtypes, middle, func)
+        self.append(", " + self.str_const_args(const.value) + ")")
+
+    def do_compare_literals(self, left, right, func, prefix):
+        # dispatch on literal values known at compile-time: strings by length, then bytes;
+        # integers by range check or bitset
+        values = set(elt.value for elt in left.elts)
+        temp = self.mv.tempcount[(left, "cmp")]
+        prefix = prefix or ""
+
+        if all(type(v) == str for v in values) and self.only_classes(right, ("str_",)):
+            values = sorted(values, key=lambda v: (len(v.encode("utf-8")), v))
+            self.append(prefix + "(")
+            for i, value in enumerate(values):
+                if i == 0:
+                    self.visitm("__eq_lit(" + temp + "=", right, func)
+                else:
+                    self.append("__eq_lit(" + temp)
+                self.append(", " + self.str_const_args(value) + ")")
+                if i != len(values) - 1:
+                    self.append(" || ")
+            self.append(")")
+            return True
+
+        if (
+            len(values) > 2
+            and all(type(v) == int for v in values)
+            and typestr.unboxable(self.gx, self.mergeinh[right]) == "int_"
+        ):
+            lo, hi = min(values), max(values)
+            if hi - lo + 1 == len(values):
+                self.visitm(prefix + "((" + temp + "=", right, func)
+                self.append(
+                    ") >= __ss_int(%d) && %s <= __ss_int(%d))" % (lo, temp, hi)
+                )
+                return True
+            if lo >= 0 and hi < 64:
+                self.visitm(prefix + "__in_bits(" + temp + "=", right, func)
+                self.append(", 0x%xULL)" % sum(1 << v for v in values))
+                return True
+
+        return False
+
     def visit2(
         self, node, argtypes, middle, func
     ):  # XXX use temp vars in comparisons, e.g. (t1=fun())
@@ -2278,6 +2704,28 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                 self.append("0, ")
 
     def visit_JoinedStr(self, node, func=None):
+        if [
+            value
+            for value in node.values
+            if isinstance(value, ast.FormattedValue)
+            and (value.format_spec or value.conversion != -1)
+        ]:
+            self.append("__fmt_write(")
+            for i, value in enumerate(node.values):
+                if isinstance(value, ast.FormattedValue):
+                    conversion = None
+                    if value.conversion != -1:
+                        conversion = chr(value.conversion)
+                    self.do_format_field(
+                        value.value, conversion, value.format_spec, func
+                    )
+                else:
+                    self.append(self.format_text(value.value))
+                if i != len(node.values) - 1:
+                    self.append(", ")
+            self.append(")")
+            return
+
         self.append("__add_strs(%d, " % len(node.values))
         for i, value in enumerate(node.values):
             if isinstance(value, ast.FormattedValue):
@@ -2287,6 +2735,135 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                 self.append(", ")
         self.append(")")
 
+    FORMAT_SPEC = re.compile(
+        r"(?:(.)?([<>=^]))?([-+ ])?(#)?(0)?(\d+)?([,_])?(?:\.(\d+))?([bcdeEfFgGnosxX%])?\Z",
+        re.DOTALL,
+    )
+
+    def format_spec(self, spec):
+        """pre-parsed format spec, or None if it should be parsed at run-time"""
+        m = self.FORMAT_SPEC.match(spec)
+        if not m:
+            return None
+        fill, align, sign, alt, zero, width, grouping, precision, type_ = m.groups()
+        chars = [("'%s'" % c if c else "0") for c in (align, sign, grouping, type_)]
+        return '__fmt_spec("%s", %s, %s, %d, %d, %s, %s, %s, %s)' % (
+            self.expand_special_chars(fill or " "),
+            chars[0],
+            chars[1],
+            bool(alt),
+            bool(zero),
+            width or -1,
+            chars[2],
+            precision or -1,
+            chars[3],
+        )
+
+    def format_text(self, text):
+        return '__fmt_text("%s", %d)' % (
+            self.expand_special_chars(text),
+            len(text.encode("utf-8")),
+        )
+
+    def do_format_field(self, node, conversion, spec, func):
+        self.append("__fmtf(")
+        if conversion == "r":
+            self.visitm("repr(", node, ")", func)
+        elif conversion == "a":
+            self.visitm("__ascii(repr(", node, "))", func)
+        elif conversion == "s":
+            self.visitm("__str(", node, ")", func)
+        else:
+            self.visit(node, func)
+
+        if isinstance(spec, ast.JoinedStr):
+            if all(isinstance(value, ast.Constant) for value in spec.values):
+                spec = "".join(value.value for value in spec.values)
+            else:
+                self.visitm(", __fmt_parse_spec(", spec, "))", func)
+                return
+        if spec:
+            parsed = self.format_spec(spec)
+            if parsed:
+                self.append(", " + parsed)
+            else:
+                self.append(
+                    ', __fmt_parse_spec("%s", %d)'
+                    % (self.expand_special_chars(spec), len(spec.encode("utf-8")))
+                )
+        self.append(")")
+
+    def compile_format(self, node):
+        """split literal format string into text and (arg, conversion, spec) fields"""
+        fmt = node.func.value
+        if not (isinstance(fmt, ast.Constant) and isinstance(fmt.value, str)):
+            return None
+        try:
+            parsed = list(string.Formatter().parse(fmt.value))
+        except ValueError:
+            return None
+
+        pieces = []
+        uses = [0 for arg in node.args]
+        auto_index = 0
+        manual = False
+        for text, field, spec, conversion in parsed:
+            if text and pieces and isinstance(pieces[-1], str):
+                pieces[-1] += text
+            elif text:
+                pieces.append(text)
+            if field is None:
+                continue
+            if field == "" and not manual:
+                index = auto_index
+                auto_index += 1
+            elif field.isdigit() and not auto_index:
+                index = int(field)
+                manual = True
+            else:
+                return None
+            if (
+                index >= len(node.args)
+                or "{" in spec
+                or (spec and not self.format_spec(spec))
+                or conversion not in (None, "r", "s", "a")
+            ):
+                return None
+            uses[index] += 1
+            pieces.append((node.args[index], conversion, spec))
+
+        # arguments are evaluated once each, unless trivial
+        for arg, count in zip(node.args, uses):
+            if count != 1 and not isinstance(arg, (ast.Name, ast.Constant)):
+                return None
+        return pieces
+
+    def do_str_format(self, node, func):
+        if node.keywords:
+            error.error(
+                "str.format: keyword arguments are not supported",
+                self.gx,
+                node,
+                mv=self.mv,
+            )
+            return
+        pieces = self.compile_format(node)
+        if pieces is not None:
+            self.append("__fmt_write(")
+            for i, piece in enumerate(pieces):
+                if isinstance(piece, str):
+                    self.append(self.format_text(piece))
+                else:
+                    self.do_format_field(piece[0], piece[1], piece[2], func)
+                if i != len(pieces) - 1:
+                    self.append(", ")
+            self.append(")")
+        else:
+            self.visitm("__str_format(", node.func.value, func)
+            for arg in node.args:
+                self.visitm(", ", arg, func)
+            self.append(")")
+
     def visit_Pass(self, node, func=None):
         pass
 
@@ -2302,6 +2879,16 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         ) = infer.analyze_callfunc(self.gx, node, merge=self.gx.merged_inh)
         funcs = infer.callfunc_targets(self.gx, node, self.gx.merged_inh)
 
+        # sum(x for x in ..) -> compiled loop
+        reduction = self.reduction(node)
+        if reduction:
+            lc = self.gx.genexp_to_lc.get(node.args[0], node.args[0])
+            if reduction == "join":
+                self.visit_ListComp(lc, func, sep=node.func.value)
+            else:
+                self.visit_ListComp(lc, func)
+            return
+
         if self.library_func(funcs, "re", None, "findall") or self.library_func(
             funcs, "re", "re_object", "findall"
         ):
@@ -2526,6 +3113,13 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             ):
                 self.visitm("__ss_is_integer(", node.func.value, ")", func)
                 return
+            elif (
+                ident == "format"
+                and self.library_func(funcs, "builtin", "str_", "format")
+                and self.only_classes(node.func.value, ("str_",))
+            ):
+                self.do_str_format(node, func)
+                return
             else:
                 self.visitm(node.func, "(", func)
 
@@ -3113,13 +3707,142 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                     continue
 
             genexpr = listcomp in self.gx.genexp_to_lc.values()
-            if declare:
+            reduction = self.lc_reduction(listcomp)
+            if reduction:
+                self.reduction_func(listcomp, reduction, declare)
+            elif declare:
                 self.listcomp_head(listcomp, True, genexpr)
             elif genexpr:
                 self.genexpr_class(listcomp, declare)
             else:
                 self.listcomp_func(listcomp)
 
+    def lc_reduction(self, node):
+        if node in self.reduction_calls and node in self.listcomps:
+            return self.reduction(self.reduction_calls[node])
+
+    def reduction(self, node):
+        # builtin reduction directly consuming a comprehension: compiled into a single loop,
+        # without an intermediate list or generator object
+        if not (len(node.args) == 1 and not node.keywords):
+            return None
+        arg = node.args[0]
+        genexpr = isinstance(arg, ast.GeneratorExp)
+        lc = self.gx.genexp_to_lc.get(arg, arg)
+        if not isinstance(lc, ast.ListComp) or lc not in self.listcomps:
+            return None
+        funcs = infer.callfunc_targets(self.gx, node, self.mergeinh)
+        elt_classes = set(t[0].ident for t in self.mergeinh[lc.elt])
+        result_types = self.mergeinh[node]
+
+        if isinstance(node.func, ast.Name):
+            ident = node.func.id
+            if not self.library_func(funcs, "builtin", None, ident):
+                return None
+            if ident in ("any", "all") and genexpr:  # short-circuits
+                return ident
+            if ident == "sum" and elt_classes and elt_classes <= {"int_", "float_", "bool_"}:
+                if set(t[0].ident for t in result_types) in ({"int_"}, {"float_"}):
+                    return ident
+            if ident in ("min", "max") and self.mergeinh[lc.elt] and typestr.typestr(
+                self.gx, self.mergeinh[lc.elt], mv=self.mv
+            ) == typestr.typestr(self.gx, result_types, mv=self.mv):
+                return ident
+
+        elif (
+            isinstance(node.func, ast.Attribute)
+            and node.func.attr == "join"
+            and self.library_func(funcs, "builtin", "str_", "join")
+            and self.only_classes(node.func.value, ("str_",))
+            and elt_classes == {"str_"}
+        ):
+            return "join"
+
+    def reduction_func(self, node, kind, declare):
+        lcfunc, func = self.listcomps[node]
+        call = self.reduction_calls[node]
+        args = [a + b for a, b in self.lc_args(lcfunc, func)]
+        if kind == "join":
+            args.append("str *__ss_sep")
+        ts = typestr.nodetypestr(self.gx, call, func, mv=self.mv)
+        if not ts.endswith("*"):
+            ts += " "
+        self.output(
+            "static inline "
+            + ts
+            + lcfunc.ident
+            + "("
+            + ", ".join(args)
+            + ")"
+            + [" {", ";"][declare]
+        )
+        if declare:
+            return
+
+        self.indent()
+        self.local_defs(lcfunc)
+        if kind == "sum":
+            self.output(ts + "__ss_result = 0;")
+        elif kind in ("min", "max"):
+            self.output(ts + "__ss_result = __zero<%s>();" % ts.rstrip())
+            self.output(ts + "__ss_elem;")
+            self.output("bool __ss_first = true;")
+        elif kind == "join":
+            self.output("str *__ss_result = new str();")
+            self.output("bool __ss_first = true;")
+        self.output("")
+
+        self.reducing = kind
+        self.listcomp_rec(node, node.generators, lcfunc, True)
+        self.reducing = None
+
+        if kind == "any":
+            self.output("return False;")
+        elif kind == "all":
+            self.output("return True;")
+        else:
+            if kind in ("min", "max"):
+                self.output("if (__ss_first)")
+                self.output(
+                    '    throw new ValueError(new str("%s() arg is an empty sequence"));'
+                    % kind
+                )
+            self.output("return __ss_result;")
+        self.deindent()
+        self.output("}\n")
+
+    def reduction_step(self, node, lcfunc):
+        kind = self.reducing
+        if kind == "sum":
+            self.start("__ss_result += ")
+            self.visit(node.elt, lcfunc)
+            self.eol()
+        elif kind in ("any", "all"):
+            self.start(["if (!(", "if (("][kind == "any"])
+            self.bool_test(node.elt, lcfunc)
+            self.append(")) return %s" % ["False", "True"][kind == "any"])
+            self.eol()
+        elif kind in ("min", "max"):
+            self.start("__ss_elem = ")
+            self.visit(node.elt, lcfunc)
+            self.eol()
+            if self.only_classes(node.elt, ("int_", "float_")):
+                compare = "__ss_elem %s __ss_result" % [">", "<"][kind == "min"]
+            else:
+                compare = "__cmp(__ss_elem, __ss_result) == %d" % [1, -1][kind == "min"]
+            self.output("if (__ss_first || %s) {" % compare)
+            self.output("    __ss_result = __ss_elem;")
+            self.output("    __ss_first = false;")
+            self.output("}")
+        else:
+            self.output("if (!__ss_first)")
+            self.output("    __ss_result->unit += __ss_sep->unit;")
+            self.output("__ss_first = false;")
+            self.start("__ss_result->unit += (")
+            self.visit(node.elt, lcfunc)
+            self.append(")->unit")
+            self.eol()
+
     def listcomp_head(self, node, declare, genexpr):
         lcfunc, func = self.listcomps[node]
         args = [a + b for a, b in self.lc_args(lcfunc, func)]
@@ -3163,18 +3886,102 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         lcfunc, func = self.listcomps[node]
         self.listcomp_head(node, False, False)
         self.indent()
-        self.local_defs(lcfunc)
+        parallel = self.parallel_listcomp(node)
+        if not parallel:  # else declared by each thread
+            self.local_defs(lcfunc)
         self.output(
             typestr.nodetypestr(self.gx, node, lcfunc, mv=self.mv)
             + "__ss_result = new "
             + typestr.nodetypestr(self.gx, node, lcfunc, mv=self.mv)[:-2]
             + "();\n"
         )
-        self.listcomp_rec(node, node.generators, lcfunc, False)
+        if parallel:
+            self.parallel_listcomp_body(node, lcfunc)
+        else:
+            self.listcomp_rec(node, node.generators, lcfunc, False)
         self.output("return __ss_result;")
         self.deindent()
         self.output("}\n")
 
+    def parallel_listcomp(self, node):
+        # calls without side-effects over a list or range (--parallel): computed by a thread pool
+        if not self.gx.parallel or len(node.generators) != 1:
+            return False
+        qual = node.generators[0]
+        if qual.ifs or qual.is_async or not isinstance(qual.target, ast.Name):
+            return False
+        if ast_utils.is_fastfor(qual):
+            args = qual.iter.args
+            if not 1 <= len(args) <= 3 or (
+                len(args) == 3
+                and not (ast_utils.is_literal(args[2]) and ast.literal_eval(args[2]) != 0)
+            ):
+                return False
+        elif not self.one_class(qual.iter, ("list",)):
+            return False
+        calls = [n for n in ast.walk(node.elt) if isinstance(n, ast.Call)]
+        return (
+            any(
+                not f.mv.module.builtin
+                for call in calls
+                for f in infer.callfunc_targets(self.gx, call, self.mergeinh)
+            )
+            and not any(isinstance(n, ast.NamedExpr) for n in ast.walk(node.elt))
+            and infer.pure_expr(self.gx, node.elt)
+        )
+
+    def parallel_listcomp_body(self, node, lcfunc):
+        qual = node.generators[0]
+        iter = self.cpp_name(python.lookup_var(qual.target.id, lcfunc, mv=self.mv))
+        if ast_utils.is_fastfor(qual):
+            args = qual.iter.args
+            self.start("__ss_int __ss_start = ")
+            if len(args) == 1:
+                self.append("0")
+            else:
+                self.visit(args[0], lcfunc)
+            self.append(", __ss_stop = ")
+            self.visit(args[0] if len(args) == 1 else args[1], lcfunc)
+            self.append(", __ss_step = ")
+            if len(args) == 3:
+                self.visit(args[2], lcfunc)
+            else:
+                self.append("1")
+            self.eol()
+            self.output("size_t __ss_n = (size_t)__range_len(__ss_start, __ss_stop, __ss_step);")
+            item = "__ss_start + (__ss_int)__ss_i * __ss_step"
+        else:
+            self.start(typestr.nodetypestr(self.gx, qual.iter, lcfunc, mv=self.mv) + "__ss_src = ")
+            self.visit(qual.iter, lcfunc)
+            self.eol()
+            self.output("size_t __ss_n = __ss_src->units.size();")
+            item = "__ss_src->units[__ss_i]"
+        self.output("__ss_result->units.resize(__ss_n);")
+        self.output("__ss_parallel_run(__ss_n, [&](size_t __ss_lo, size_t __ss_hi) {")
+        self.indent()
+        # private to each thread, including temporaries for the element
+        temps = set(self.mv.tempcount.values())
+        self.local_defs(lcfunc, (set(lcfunc.vars) - temps) | self.temps_in(node.elt))
+        self.output("for(size_t __ss_i = __ss_lo; __ss_i < __ss_hi; __ss_i++) {")
+        self.indent()
+        self.output("%s = %s;" % (iter, item))
+        self.start("__ss_result->units[__ss_i] = ")
+        self.visit(node.elt, lcfunc)
+        self.eol()
+        self.deindent()
+        self.output("}")
+        self.deindent()
+        self.output("});")
+
+    def temps_in(self, node):
+        # temporaries for (parts of) node
+        nodes = set(ast.walk(node))
+        return set(
+            name
+            for key, name in self.mv.tempcount.items()
+            if (key[0] if isinstance(key, tuple) else key) in nodes
+        )
+
     def genexpr_class(self, node, declare):
         lcfunc, func = self.listcomps[node]
         args = self.lc_args(lcfunc, func)
@@ -3211,9 +4018,11 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             self.deindent()
             self.output("}\n")
 
-    def local_defs(self, func: python.Function):
+    def local_defs(self, func: python.Function, names=None):
         pairs = []
         for name, var in func.vars.items():
+            if names is not None and name not in names:
+                continue
             if not var.invisible and (
                 not hasattr(func, "formals") or name not in func.formals
             ):  # XXX
@@ -3228,22 +4037,16 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
     # --- nested for loops: loop headers, if statements
     def listcomp_rec(self, node, quals, lcfunc, genexpr):
         if not quals:
-            if genexpr:
+            if self.reducing:
+                self.reduction_step(node, lcfunc)
+                return
+            elif genexpr:
                 self.start("__result = ")
                 self.visit(node.elt, lcfunc)
                 self.eol()
                 self.output("return __result;")
                 self.start("__after_yield_0:")
-            elif (
-                len(node.generators) == 1
-                and not ast_utils.is_fastfor(node.generators[0])
-                and not self.fastenumerate(node.generators[0])
-                and not self.fastzip2(node.generators[0])
-                and not node.generators[0].ifs
-                and self.one_class(
-                    node.generators[0].iter, ("tuple", "list", "str_", "dict", "set")
-                )
-            ):
+            elif self.presized(node):
                 self.start(
                     "__ss_result->units["
                     + self.mv.tempcount[node.generators[0].iter]
@@ -3266,7 +4069,26 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             var = python.lookup_var(self.mv.tempcount[qual.target], lcfunc, mv=self.mv)
         iter = self.cpp_name(var)
 
-        if ast_utils.is_fastfor(qual):
+        if ast_utils.is_let_binding(qual):
+            self.start(iter + " = ")
+            self.impl_visit_conv(qual.iter.elts[0], self.mergeinh[var], lcfunc)
+            self.eol()
+            if ast_utils.is_assign_list_or_tuple(qual.target):
+                self.tuple_assign(qual.target, iter, lcfunc)
+            self.listcompbind_body(node, quals, lcfunc, genexpr)
+        elif ast_utils.is_fastfor(qual):
+            if not genexpr and self.reserve_range(node, qual):
+                self.start("__ss_result->units.reserve(__range_len(")
+                if len(qual.iter.args) == 1:
+                    self.append("0, ")
+                for i, arg in enumerate(qual.iter.args):
+                    self.visit(arg, lcfunc)
+                    if i != len(qual.iter.args) - 1:
+                        self.append(", ")
+                if len(qual.iter.args) != 3:
+                    self.append(", 1")
+                self.append("))")
+                self.eol()
             self.do_fastfor(node, qual, quals, iter, lcfunc, genexpr)
         elif self.fastenumerate(qual):
             self.do_fastenumerate(qual, lcfunc, genexpr)
@@ -3277,6 +4099,9 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         elif self.fastdictiter(qual):
             self.do_fastdictiter(qual, lcfunc, genexpr)
             self.listcompfor_body(node, quals, iter, lcfunc, True, genexpr)
+        elif self.lazysplit(qual):
+            self.do_lazysplit(qual, iter, lcfunc)
+            self.listcompfor_body(node, quals, iter, lcfunc, False, genexpr)
         else:
             if not isinstance(qual.iter, ast.Name):
                 itervar = self.mv.tempcount[qual]
@@ -3286,16 +4111,70 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             else:
                 itervar = self.cpp_name(qual.iter.id)
 
-            pref, tail = self.forin_preftail(qual)
+            body = [node.elt] + qual.ifs + [q for q in node.generators if q is not qual]
+            pref, tail = self.forin_preftail(qual, body, lcfunc, genexpr and not self.reducing)
 
-            if len(node.generators) == 1 and not qual.ifs and not genexpr:
-                if self.one_class(qual.iter, ("list", "tuple", "str_", "dict", "set")):
-                    self.output("__ss_result->resize(len(" + itervar + "));")
+            if not genexpr and qual is node.generators[0] and self.presized(node):
+                self.output("__ss_result->resize(len(" + itervar + "));")
 
             self.start("FOR_IN" + pref + "(" + iter + "," + itervar + "," + tail)
             self.print(self.line + ")")
             self.listcompfor_body(node, quals, iter, lcfunc, False, genexpr)
 
+    def presized(self, node):
+        # sized source, followed only by bindings, without conditions: write result in-place
+        qual = node.generators[0]
+        return (
+            not [q for q in node.generators if q.ifs]
+            and all(ast_utils.is_let_binding(q) for q in node.generators[1:])
+            and not ast_utils.is_let_binding(qual)
+            and not ast_utils.is_fastfor(qual)
+            and not self.fastenumerate(qual)
+            and not self.fastzip2(qual)
+            and not self.lazysplit(qual)
+            and self.one_class(qual.iter, ("tuple", "list", "str_", "dict", "set"))
+        )
+
+    def reserve_range(self, node, qual):
+        # range arguments are evaluated twice, so they must be free of side-effects
+        return (
+            qual is node.generators[0]
+            and not [q for q in node.generators if q.ifs]
+            and all(ast_utils.is_let_binding(q) for q in node.generators[1:])
+            and all(
+                isinstance(arg, ast.Name)
+                or ast_utils.is_literal(arg)
+                or (
+                    isinstance(arg, ast.Call)
+                    and isinstance(arg.func, ast.Name)
+                    and arg.func.id == "len"
+                    and len(arg.args) == 1
+                    and isinstance(arg.args[0], ast.Name)
+                    and self.only_classes(arg.args[0], ("list", "tuple", "str_", "dict", "set"))
+                )
+                for arg in qual.iter.args
+            )
+        )
+
+    def listcompbind_body(self, node, quals, lcfunc, genexpr):
+        qual = quals[0]
+
+        if qual.ifs:
+            self.start("if (")
+            for cond in qual.ifs:
+                self.bool_test(cond, lcfunc)
+                if cond != qual.ifs[-1]:
+                    self.append(" && ")
+            self.append(") {")
+            self.print(self.line)
+            self.indent()
+
+        self.listcomp_rec(node, quals[1:], lcfunc, genexpr)
+
+        if qual.ifs:
+            self.deindent()
+            self.output("}")
+
     def listcompfor_body(self, node, quals, iter, lcfunc, skip, genexpr):
         qual = quals[0]
 
@@ -3328,7 +4207,7 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
     def visit_GeneratorExp(self, node, func=None):
         self.visit(self.gx.genexp_to_lc[node], func)
 
-    def visit_ListComp(self, node, func=None):
+    def visit_ListComp(self, node, func=None, sep=None):
         lcfunc, _ = self.listcomps[node]
         args = []
         temp = self.line
@@ -3342,9 +4221,14 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                     args.append(self.cpp_name(var))
 
         self.line = temp
-        if node in self.gx.genexp_to_lc.values():
+        if node in self.gx.genexp_to_lc.values() and not self.lc_reduction(node):
             self.append("new ")
-        self.append(lcfunc.ident + "(" + ", ".join(args) + ")")
+        self.append(lcfunc.ident + "(" + ", ".join(args))
+        if sep:
+            if args:
+                self.append(", ")
+            self.visit(sep, func)
+        self.append(")")
 
     def visit_Subscript(self, node, func=None):
         if type(node.ctx) in (ast.Load, ast.Store):
@@ -3414,6 +4298,8 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             name = ident
         if module and module.builtin:
             return self.namer.nokeywords(name)
+        elif isinstance(name, python.Variable):
+            return self.member_ref(name)
         else:
             return self.cpp_name(name)
 
@@ -3758,6 +4644,104 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         self.visit_const(node, node.value)
 
 
+def field_layout(gx, ts):
+    """estimated (size, alignment) of a member of C++ type ts"""
+    ts = ts.strip()
+    if ts.endswith("*"):
+        return 8, 8
+    elif ts == "__ss_bool":
+        return 1, 1
+    elif ts == "__ss_int":
+        size = 16 if gx.int128 else 8 if gx.int64 else 4
+        return size, size
+    elif ts == "__ss_float":
+        return (4, 4) if gx.float32 else (8, 8)
+    elif ts == "complex":
+        return (8, 4) if gx.float32 else (16, 8)
+    return 8, 8
+
+
+def attribute_heat(gx):
+    """static estimate of how often each attribute name is accessed: references
+    in the program, weighted by loop nesting depth"""
+    if gx.attribute_heat is None:
+        heat = {}
+
+        def walk(node, depth):
+            if isinstance(node, ast.Attribute):
+                heat[node.attr] = heat.get(node.attr, 0) + 10 ** min(depth, 6)
+            if isinstance(node, (ast.For, ast.While, ast.comprehension)):
+                depth += 1
+            for child in ast.iter_child_nodes(node):
+                walk(child, depth)
+
+        for module in gx.modules.values():
+            if not module.builtin:
+                walk(module.ast, 0)
+        gx.attribute_heat = heat
+    return gx.attribute_heat
+
+
+def instance_variables(gx, cl):
+    """instance variables introduced by cl, ordered by decreasing alignment so no
+    padding is needed between them; hot fields go first within an alignment"""
+    masked = set()  # var is masked by ancestor var
+    for ancestor in cl.ancestors():
+        masked.update(ancestor.vars)
+    result = []
+    for var in cl.vars.values():
+        if var.invisible or var.name in masked:
+            continue
+        if var in gx.merged_inh and gx.merged_inh[var]:
+            ts = typestr.nodetypestr(gx, var, cl, mv=cl.mv)
+            result.append((field_layout(gx, ts), var))
+    heat = attribute_heat(gx)
+    order = {var: i for i, (_, var) in enumerate(result)}
+    result.sort(key=lambda x: (-x[0][1], -heat.get(x[1].name, 0), order[x[1]]))
+    return [var for (_, var) in result]
+
+
+def soa_class(gx, cl):
+    """is cl marked '# shedskin: soa', without base classes or subclasses"""
+    return "soa" in python.class_directives(cl) and not cl.bases and not cl.children
+
+
+def class_layout(gx, cl):
+    """estimated instance layout of cl under the Itanium C++ ABI, as (size, data size,
+    alignment, data size of base, bytes in own fields)"""
+    if cl.bases and not cl.bases[0].mv.module.builtin:
+        _, offset, align, _, _ = class_layout(gx, cl.bases[0])
+    else:
+        offset, align = 16, 8  # vtable pointer, __class__
+    base, used = offset, 0
+    for var in instance_variables(gx, cl):
+        ts = typestr.nodetypestr(gx, var, cl, mv=cl.mv)
+        size, falign = field_layout(gx, ts)
+        offset = (offset + falign - 1) // falign * falign + size
+        align = max(align, falign)
+        used += size
+    return (offset + align - 1) // align * align, offset, align, base, used
+
+
+def layout_report(gx):
+    lines = []
+    for module in gx.modules.values():
+        if not module.builtin:
+            for cl in module.mv.classes.values():
+                size, _, _, base, used = class_layout(gx, cl)
+                if soa_class(gx, cl):
+                    lines.append(
+                        "%s.%s: %d-byte handle, %d bytes in attribute arrays"
+                        % (module.ident, cl.ident, base, used)
+                    )
+                    continue
+                lines.append(
+                    "%s.%s: %d bytes (%d inherited, %d in fields, %d padding)"
+                    % (module.ident, cl.ident, size, base, used, size - base - used)
+                )
+    return lines
+
+
 def generate_code(gx):
     for module in gx.modules.values():
         if not module.builtin:
@@ -264,7 +264,7 @@ class ExtensionModule:
         for i, var in enumerate(vars):
             write(
                 "    PyTuple_SetItem(b, %d, __to_py(((%sObject *)self)->__ss_object->%s));"
-                % (i, clname(cl), self.gv.cpp_name(var))
+                % (i, clname(cl), self.gv.member_ref(var))
             )
         write("    PyTuple_SetItem(t, 2, b);")
         write("    return t;")
@@ -274,12 +274,13 @@ class ExtensionModule:
             % clname(cl)
         )
         write("    (void)kwargs;")
+        self.register_thread("    ")
         write("    PyObject *state = PyTuple_GetItem(args, 0);")
         for i, var in enumerate(vars):
             vartype = typestr.nodetypestr(self.gx, var, var.parent, mv=self.gv.mv)
             write(
                 "    ((%sObject *)self)->__ss_object->%s = __to_ss<%s>(PyTuple_GetItem(state, %d));"
-                % (clname(cl), self.gv.cpp_name(var), vartype, i)
+                % (clname(cl), self.gv.member_ref(var), vartype, i)
             )
         write("    Py_INCREF(Py_None);")
         write("    return Py_None;")
@@ -399,6 +400,10 @@ class ExtensionModule:
             write(
                 '    {(char *)"__newobj__", (PyCFunction)__ss__newobj__, METH_VARARGS | METH_KEYWORDS, (char *)""},'
             )
+            if self.gx.stats:
+                write(
+                    '    {(char *)"__ss_stats__", (PyCFunction)__ss__stats__, METH_NOARGS, (char *)""},'
+                )
         elif cl and python.def_class(self.gx, "Exception") not in cl.ancestors():
             write(
                 '    {(char *)"__reduce__", (PyCFunction)%s__reduce__, METH_VARARGS | METH_KEYWORDS, (char *)""},'
@@ -413,13 +418,140 @@ class ExtensionModule:
                 id = clname(func.parent) + "_" + func.ident
             else:
                 id = "Global_" + "_".join(self.gv.module.name_list) + "_" + func.ident
-            write(
-                '    {(char *)"%(id)s", (PyCFunction)%(id2)s, METH_VARARGS | METH_KEYWORDS, (char *)""},'
-                % {"id": func.ident, "id2": id}
-            )
+            if self.fastcall(func):
+                write(
+                    '    {(char *)"%(id)s", (PyCFunction)(void (*)(void))%(id2)s, METH_FASTCALL | METH_KEYWORDS, (char *)""},'
+                    % {"id": func.ident, "id2": id}
+                )
+            else:
+                write(
+                    '    {(char *)"%(id)s", (PyCFunction)%(id2)s, METH_VARARGS | METH_KEYWORDS, (char *)""},'
+                    % {"id": func.ident, "id2": id}
+                )
+            if not cl and self.batch_types(func):
+                write(
+                    '    {(char *)"%(id)s_many", (PyCFunction)%(id2)s_many, METH_O, (char *)""},'
+                    % {"id": func.ident, "id2": id}
+                )
         # write("    {NULL}\n};\n")
         write("    {NULL, NULL, 0, NULL}\n};\n")
 
+    def fastcall(self, func):
+        """
+        Determines if a function is exported with the vectorcall convention
+
+        (number protocol slots and tp_init use their own calling conventions)
+
+        :param      func:  The function
+        :type       func:  python.Function
+
+        :returns:   True if METH_FASTCALL, False otherwise.
+        :rtype:     bool
+        """
+        return func.ident not in OVERLOAD and func.ident != "__init__"
+
+    def nogil(self, func):
+        """
+        Determines if the GIL is released while a function runs
+
+        :param      func:  The function
+        :type       func:  python.Function
+
+        :returns:   True if --nogil or '# shedskin: nogil', False otherwise.
+        :rtype:     bool
+        """
+        return self.gx.nogil or "nogil" in python.function_directives(func)
+
+    def register_thread(self, indent):
+        """
+        Registers the calling thread with the GC on entry, before anything is
+        allocated: it may be a Python thread the GC has never seen, while
+        another thread collects without holding the GIL
+
+        :param      indent:  The indentation
+        :type       indent:  str
+        """
+        if python.gc_threads(self.gx):
+            self.write(indent + "__ss_gc_register_thread();")
+
+    def proxy(self, func):
+        """
+        Determines if a function returns containers as lazy proxies
+
+        :param      func:  The function
+        :type       func:  python.Function
+
+        :returns:   True if --proxy or '# shedskin: proxy', False otherwise.
+        :rtype:     bool
+        """
+        return self.gx.proxy or "proxy" in python.function_directives(func)
+
+    def batch_types(self, func):
+        """
+        Determines the argument types of a function exported with a batch variant
+
+        (only module-level functions with scalar or string arguments)
+
+        :param      func:  The function
+        :type       func:  python.Function
+
+        :returns:   The argument types if --batch applies, None otherwise.
+        :rtype:     list
+        """
+        if (
+            not self.gx.batch
+            or isinstance(func.parent, python.Class)
+            or not func.formals
+        ):
+            return None
+        types = [
+            typestr.nodetypestr(self.gx, func.vars[formal], func, mv=self.gv.mv)
+            for formal in func.formals
+        ]
+        if all(
+            t.strip() in ("__ss_int", "__ss_float", "__ss_bool", "str *") for t in types
+        ):
+            return types
+        return None
+
+    def do_extmod_batch(self, func, types):
+        """
+        Generates '<name>_many(iterable)', which calls a function for each item
+        (or tuple of arguments) of an iterable, looping in C++
+
+        :param      func:   The function
+        :type       func:   python.Function
+        :param      types:  The argument types
+        :type       types:  list
+        """
+        write = self.write
+        id = "Global_" + "_".join(self.gv.module.name_list) + "_" + func.ident
+        call = "__" + self.gv.module.ident + "__::" + self.gv.cpp_name(func.ident)
+        write("PyObject *%s_many(PyObject *self, PyObject *arg) {" % id)
+        write("    (void)self;")
+        self.register_thread("    ")
+        write("    try {")
+        if len(types) == 1:
+            write(
+                "        return __ss_many1<%s>(arg, [](%sx) { return %s(x); });"
+                % (types[0].strip(), types[0], call)
+            )
+        else:
+            args = ", ".join(
+                "__to_ss<%s>(a[%d])" % (t.strip(), i) for i, t in enumerate(types)
+            )
+            write(
+                "        return __ss_many(arg, %d, [](PyObject *const *a) { return __to_py(%s(%s)); });"
+                % (len(types), call, args)
+            )
+        write("    } catch (Exception *e) {")
+        write(
+            '        PyErr_SetString(__to_py(e), ((e->message)?(e->message->c_str()):""));'
+        )
+        write("        return 0;")
+        write("    }")
+        write("}\n")
+
     def do_extmod_method(self, func):
         """
         Does an extmod method.
@@ -441,10 +573,41 @@ class ExtensionModule:
             id = clname(func.parent) + "_" + func.ident
         else:
             id = "Global_" + "_".join(self.gv.module.name_list) + "_" + func.ident
-        write("PyObject *%s(PyObject *self, PyObject *args, PyObject *kwargs) {" % id)
-        write("    (void)self; (void)args; (void)kwargs;")
+        stat = None
+        if self.gx.stats:
+            stat = "__ss_stat_" + id
+            if is_method:
+                name = func.parent.ident + "." + func.ident
+            else:
+                name = func.ident
+            write('static __ss_stat %s("%s");\n' % (stat, name))
+        fast = self.fastcall(func)
+        if fast:
+            write(
+                "PyObject *%s(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {"
+                % id
+            )
+            write("    (void)self; (void)args; (void)nargs; (void)kwnames;")
+            if formals:
+                write(
+                    "    static PyObject *kwname[] = {%s};"
+                    % ", ".join('PyUnicode_InternFromString("%s")' % f for f in formals)
+                )
+        else:
+            write("PyObject *%s(PyObject *self, PyObject *args, PyObject *kwargs) {" % id)
+            write("    (void)self; (void)args; (void)kwargs;")
+        if stat:
+            write("    __ss_timer __ss_time(%s);" % stat)
+        self.register_thread("    ")
         write("    try {")
 
+        # copy in-place changes to array arguments back to the caller's buffers
+        if any(
+            "__array__::array" in typestr.nodetypestr(self.gx, func.vars[formal], func, mv=self.gv.mv)
+            for formal in formals
+        ):
+            write("        __array__::__ss_writeback __ss_sync;")
+
         for i, formal in enumerate(formals):
             self.gv.start("")
             typ = typestr.nodetypestr(self.gx, func.vars[formal], func, mv=self.gv.mv)
@@ -454,10 +617,16 @@ class ExtensionModule:
                     % {"type": typ, "num": i}
                 )
                 continue
-            self.gv.append(
-                '        %(type)sarg_%(num)d = __ss_arg<%(type)s>("%(name)s", %(num)d, '
-                % {"type": typ, "num": i, "name": formal}
-            )
+            if fast:
+                self.gv.append(
+                    "        %(type)sarg_%(num)d = __ss_fastarg<%(type)s>(kwname[%(num)d], %(num)d, "
+                    % {"type": typ, "num": i}
+                )
+            else:
+                self.gv.append(
+                    '        %(type)sarg_%(num)d = __ss_arg<%(type)s>("%(name)s", %(num)d, '
+                    % {"type": typ, "num": i, "name": formal}
+                )
             if i >= len(formals) - len(func.defaults):
                 self.gv.append("1, ")
                 defau = func.defaults[i - (len(formals) - len(func.defaults))]
@@ -480,7 +649,10 @@ class ExtensionModule:
                 self.gv.append("0, False")
             else:
                 self.gv.append("0, 0")
-            self.gv.append(", args, kwargs)")
+            if fast:
+                self.gv.append(", args, nargs, kwnames)")
+            else:
+                self.gv.append(", args, kwargs)")
             self.gv.eol()
         write("")
 
@@ -489,14 +661,32 @@ class ExtensionModule:
             where = "((%sObject *)self)->__ss_object->" % clname(func.parent)
         else:
             where = "__" + self.gv.module.ident + "__::"
-        write(
-            "        return __to_py("
-            + where
+        call = (
+            where
             + self.gv.cpp_name(func.ident)
             + "("
             + ", ".join("arg_%d" % i for i in range(len(formals)))
-            + "));\n"
+            + ")"
         )
+        to_py = "__to_py_lazy" if self.proxy(func) else "__to_py"
+        if stat:
+            write("        __ss_time.lap(%s.args);" % stat)
+        if self.nogil(func):
+            write("        auto __ss_ret = [&] {")
+            write("            __ss_nogil __ss_unlock;")
+            write("            return %s;" % call)
+            write("        }();")
+        elif stat:
+            write("        auto __ss_ret = %s;" % call)
+        else:
+            write("        return %s(%s);\n" % (to_py, call))
+        if stat:
+            write("        __ss_time.lap(%s.body);" % stat)
+            write("        PyObject *__ss_result = %s(__ss_ret);" % to_py)
+            write("        __ss_time.lap(%s.result);" % stat)
+            write("        return __ss_result;\n")
+        elif self.nogil(func):
+            write("        return %s(__ss_ret);\n" % to_py)
 
         # convert exceptions
         write("    } catch (Exception *e) {")
@@ -529,6 +719,9 @@ class ExtensionModule:
         funcs = self.supported_funcs(self.gv.module.mv.funcs.values())
         for func in funcs:
             self.do_extmod_method(func)
+            types = self.batch_types(func)
+            if types:
+                self.do_extmod_batch(func, types)
         self.do_extmod_methoddef(
             "Global_" + "_".join(self.gv.module.name_list), funcs, None
         )
@@ -678,6 +871,7 @@ class ExtensionModule:
         write(
             "    (void)args; (void)kwargs;"
         )
+        self.register_thread("    ")
         write(
             "    %sObject *self = (%sObject *)type->tp_alloc(type, 0);"
             % (clname(cl), clname(cl))
@@ -707,7 +901,9 @@ class ExtensionModule:
                 % (clname(cl), var.name, clname(cl))
             )
             write("    (void)closure;");
-            write("    return __to_py(self->__ss_object->%s);" % self.gv.cpp_name(var))
+            write(
+                "    return __to_py(self->__ss_object->%s);" % self.gv.member_ref(var)
+            )
             write("}\n")
 
             write(
@@ -715,14 +911,17 @@ class ExtensionModule:
                 % (clname(cl), var.name, clname(cl))
             )
             write("    (void)closure;");
+            self.register_thread("    ")
             write("    try {")
             typ = typestr.nodetypestr(self.gx, var, var.parent, mv=self.gv.mv)
             if typ == "void *":  # XXX investigate
-                write("        self->__ss_object->%s = NULL;" % self.gv.cpp_name(var))
+                write(
+                    "        self->__ss_object->%s = NULL;" % self.gv.member_ref(var)
+                )
             else:
                 write(
                     "        self->__ss_object->%s = __to_ss<%s>(value);"
-                    % (self.gv.cpp_name(var), typ)
+                    % (self.gv.member_ref(var), typ)
                 )
             write("    } catch (Exception *e) {")
             write(
@@ -191,6 +191,7 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
         self.listcomps = []
         self.defaults = {}
         self.importnodes = []
+        self.fusion = None
 
     def visit(self, node, *args):
         if (node, 0, 0) not in self.gx.cnode:
@@ -511,18 +512,16 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
 
     def visit_JoinedStr(self, node, func=None):
         for value in node.values:
+            conversion = -1
             if isinstance(value, ast.FormattedValue):
                 if value.format_spec:
-                    error.error(
-                        "f-string format spec is not supported",
-                        self.gx,
-                        node,
-                        warning=True,
-                        mv=getmv(),
-                    )
+                    self.visit(value.format_spec, func)
+                conversion = value.conversion
                 value = value.value
             self.visit(value, func)
             self.fake_func(infer.inode(self.gx, value), value, "__str__", [], func)
+            if conversion in (ord("r"), ord("a")):
+                self.fake_func(infer.inode(self.gx, value), value, "__repr__", [], func)
         self.instance(node, python.def_class(self.gx, "str_"), func)
 
     def visit_Expr(self, node, func=None):
@@ -1165,7 +1164,7 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
             if msg == "contains":
                 self.fake_func(node, right, "__" + msg + "__", [left], func)
 
-                if isinstance(right, (ast.List, ast.Tuple)) and right.elts: # expr in [..]/(..) opt
+                if isinstance(right, (ast.List, ast.Tuple, ast.Set)) and right.elts: # expr in [..]/(..)/{..} opt
                     self.temp_var2((right, 'cmp'), infer.inode(self.gx, right.elts[0]), func)
 
             elif msg in ("lt", "gt", "le", "ge"):
@@ -1586,6 +1585,8 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
         lcfunc.ident = "l.c."  # XXX
         lcfunc.parent = func
 
+        ast_utils.fuse_comprehension(node, *self.fusion_info())
+
         for qual in node.generators:
             # iter
             assnode = infer.CNode(self.gx, qual.target, parent=func, mv=getmv())
@@ -1635,6 +1636,27 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
         lcfunc.ident = "list_comp_" + str(len(self.listcomps))
         self.listcomps.append((node, lcfunc, func))
 
+    def fusion_info(self):
+        # module-level functions and names of user-defined methods, for purity checks
+        if self.fusion is None:
+            funcs = {
+                child.name: child
+                for child in self.module.ast.body
+                if isinstance(child, ast.FunctionDef)
+            }
+            methods = set()
+            for module in self.gx.modules.values():
+                if not module.builtin and module.ast:
+                    for child in ast.walk(module.ast):
+                        if isinstance(child, ast.ClassDef):
+                            methods.update(
+                                meth.name
+                                for meth in child.body
+                                if isinstance(meth, ast.FunctionDef)
+                            )
+            self.fusion = (funcs, methods)
+        return self.fusion
+
     def visit_DictComp(self, node, func=None):
         error.error("dict comprehensions are not supported", self.gx, node, mv=getmv())
 
@@ -2337,6 +2359,8 @@ def parse_module(name, gx, parent=None, node=None):
 
     # --- not cached, so parse
     module.ast = python.parse_file(module.filename)
+    if not module.builtin:
+        ast_utils.GeneratorInliner(module.ast)
 
     old_mv = getmv()
     module.mv = mv = ModuleVisitor(module, gx)
@@ -1933,3 +1933,451 @@ def default_var(
 
 def var_types(gx: "config.GlobalInfo", var):
     return inode(gx, var).types()
+
+
+# --- side-effect analysis: calls that may run in parallel (--parallel)
+
+MUTATORS = {
+    "append", "extend", "insert", "remove", "pop", "clear", "sort", "reverse",
+    "add", "discard", "update", "setdefault", "popitem", "difference_update",
+    "intersection_update", "symmetric_difference_update", "__setitem__",
+    "__delitem__", "__iadd__", "__imul__", "__next__", "appendleft",
+    "extendleft", "popleft", "rotate", "fromlist", "frombytes", "fromfile",
+    "byteswap",
+}
+PURE_MODULES = {"math", "cmath", "colorsys", "bisect", "copy", "string", "itertools"}
+IMPURE_BUILTINS = {"open", "open_binary", "input", "__print", "next", "setattr", "exit", "quit"}
+
+
+def fresh_expr(node) -> bool:
+    """expression that always creates a new object"""
+    if isinstance(
+        node,
+        (ast.List, ast.Dict, ast.Set, ast.ListComp, ast.DictComp, ast.SetComp,
+         ast.Constant, ast.JoinedStr, ast.BinOp),
+    ):
+        return True
+    return (
+        isinstance(node, ast.Call)
+        and isinstance(node.func, ast.Name)
+        and node.func.id in ("list", "dict", "set", "bytearray", "sorted", "str", "tuple")
+    )
+
+
+def fresh_names(func) -> set:
+    """local names that only ever refer to objects created by the function itself, so
+    that changing them cannot be observed elsewhere"""
+    assigned = {}
+    for node in ast.walk(func.node):
+        if isinstance(node, ast.Assign):
+            for target in node.targets:
+                if isinstance(target, ast.Name):
+                    assigned[target.id] = assigned.get(target.id, True) and fresh_expr(node.value)
+                else:
+                    for name in ast.walk(target):
+                        if isinstance(name, ast.Name):
+                            assigned[name.id] = False
+        elif isinstance(node, (ast.For, ast.comprehension, ast.AnnAssign, ast.NamedExpr, ast.withitem)):
+            target = node.optional_vars if isinstance(node, ast.withitem) else node.target
+            for name in ast.walk(target) if target else ():
+                if isinstance(name, ast.Name):
+                    assigned[name.id] = False
+    fresh = set(name for name, ok in assigned.items() if ok and name not in func.formals)
+    if func.ident == "__init__" and func.formals:  # object under construction
+        fresh.add(func.formals[0])
+    return fresh
+
+
+def pure_target(node, fresh) -> bool:
+    if isinstance(node, (ast.Tuple, ast.List)):
+        return all(pure_target(elt, fresh) for elt in node.elts)
+    elif isinstance(node, ast.Starred):
+        return pure_target(node.value, fresh)
+    elif isinstance(node, (ast.Attribute, ast.Subscript)):
+        return isinstance(node.value, ast.Name) and node.value.id in fresh
+    return True
+
+
+def pure_call(gx: "config.GlobalInfo", node, fresh, seen) -> bool:
+    objexpr, ident, direct_call, method_call, constructor, parent_constr, anon_func = analyze_callfunc(
+        gx, node, merge=gx.merged_inh
+    )
+    funcs = callfunc_targets(gx, node, gx.merged_inh)
+    if not funcs and not constructor:
+        return False
+
+    # functions passed as arguments may be called
+    for arg in node.args + [kw.value for kw in node.keywords]:
+        for t in gx.merged_inh.get(arg, ()):
+            if isinstance(t[0], python.Function) and not pure_function(gx, t[0], seen):
+                return False
+
+    for func in funcs:
+        if not func.mv.module.builtin:
+            if not pure_function(gx, func, seen):
+                return False
+        elif isinstance(func.parent, python.Class):
+            if func.parent.ident in ("file", "file_binary"):
+                return False
+            if (
+                func.ident in MUTATORS
+                and not constructor
+                and not (isinstance(objexpr, ast.Name) and objexpr.id in fresh)
+            ):
+                return False
+        elif func.mv.module.ident == "builtin":
+            if func.ident in IMPURE_BUILTINS:
+                return False
+        elif func.mv.module.ident not in PURE_MODULES or func.ident.startswith("insort"):
+            return False
+    return True
+
+
+def pure_expr(gx: "config.GlobalInfo", node, fresh=frozenset(), seen=None) -> bool:
+    """no writes to global variables or to objects that may be shared, and no I/O"""
+    if seen is None:
+        seen = set()
+    for child in ast.walk(node):
+        if isinstance(child, (ast.Global, ast.Nonlocal, ast.Yield, ast.YieldFrom, ast.Await)):
+            return False
+        targets = []
+        if isinstance(child, (ast.Assign, ast.Delete)):
+            targets = child.targets
+        elif isinstance(child, (ast.AugAssign, ast.AnnAssign, ast.For, ast.comprehension, ast.NamedExpr)):
+            targets = [child.target]
+        elif isinstance(child, ast.withitem) and child.optional_vars:
+            targets = [child.optional_vars]
+        if not all(pure_target(target, fresh) for target in targets):
+            return False
+        if isinstance(child, ast.Call) and not pure_call(gx, child, fresh, seen):
+            return False
+    return True
+
+
+def pure_function(gx: "config.GlobalInfo", func, seen=None) -> bool:
+    if seen is None:
+        seen = set()
+    if func in seen:  # recursion: decided by the other calls
+        return True
+    seen.add(func)
+    if not isinstance(func.node, (ast.FunctionDef, ast.Lambda)) or func.isGenerator:
+        return False
+    return pure_expr(gx, func.node, fresh_names(func), seen)
+
+
+def name_refs(node):
+    """(name, store) for each name in 'node', roughly in evaluation order"""
+    if isinstance(node, ast.Name):
+        yield node.id, isinstance(node.ctx, (ast.Store, ast.Del))
+    elif isinstance(node, (ast.Assign, ast.AnnAssign)):
+        if node.value:
+            yield from name_refs(node.value)
+        for target in node.targets if isinstance(node, ast.Assign) else [node.target]:
+            yield from name_refs(target)
+    elif isinstance(node, ast.AugAssign):
+        if isinstance(node.target, ast.Name):
+            yield node.target.id, False
+        yield from name_refs(node.target)
+        yield from name_refs(node.value)
+    elif isinstance(node, ast.NamedExpr):
+        yield from name_refs(node.value)
+        yield from name_refs(node.target)
+    elif isinstance(node, (ast.For, ast.comprehension)):
+        yield from name_refs(node.iter)
+        yield from name_refs(node.target)
+        for child in node.ifs if isinstance(node, ast.comprehension) else node.body + node.orelse:
+            yield from name_refs(child)
+    elif isinstance(node, (ast.ListComp, ast.SetComp, ast.GeneratorExp, ast.DictComp)):
+        for qual in node.generators:
+            yield from name_refs(qual)
+        for child in [node.key, node.value] if isinstance(node, ast.DictComp) else [node.elt]:
+            yield from name_refs(child)
+    else:
+        for child in ast.iter_child_nodes(node):
+            yield from name_refs(child)
+
+
+def assigned_first(stmts, names, assigned):
+    """names assigned on every path through 'stmts', given those in 'assigned', or None
+    if no path falls through. raises ValueError when one of 'names' may be read before
+    it is assigned. names bound by ':=' only count when always evaluated"""
+    assigned = set(assigned)
+
+    def reads(node):
+        maybe = set()  # a and (x := ..), .. if (x := ..) else .., [(x := ..) for ..]
+        for child in ast.walk(node):
+            if isinstance(child, ast.BoolOp):
+                parts = child.values[1:]
+            elif isinstance(child, ast.IfExp):
+                parts = [child.body, child.orelse]
+            elif isinstance(child, (ast.ListComp, ast.SetComp, ast.GeneratorExp, ast.DictComp)):
+                parts = [child]
+            else:
+                continue
+            for part in parts:
+                maybe.update(n for n in ast.walk(part) if isinstance(n, ast.NamedExpr))
+        for name, store in name_refs(node):
+            if not store and name in names and name not in assigned:
+                raise ValueError(name)
+        assigned.update(
+            n.target.id for n in ast.walk(node) if isinstance(n, ast.NamedExpr) and n not in maybe
+        )
+
+    for stmt in stmts:
+        if isinstance(stmt, ast.If):
+            reads(stmt.test)
+            body = assigned_first(stmt.body, names, assigned)
+            orelse = assigned_first(stmt.orelse, names, assigned)
+            if body is None or orelse is None:
+                assigned = orelse if body is None else body
+            else:
+                assigned = body & orelse
+        elif isinstance(stmt, (ast.For, ast.While)):  # the body may not run
+            if isinstance(stmt, ast.For):
+                reads(stmt.iter)
+                targets = set(name for name, store in name_refs(stmt.target))
+                assigned_first(stmt.body, names, assigned | targets)
+            else:
+                reads(stmt.test)
+                assigned_first(stmt.body, names, assigned)
+            assigned_first(stmt.orelse, names, assigned)
+        elif isinstance(stmt, ast.With):
+            for item in stmt.items:
+                reads(item.context_expr)
+                if item.optional_vars:
+                    assigned.update(name for name, store in name_refs(item.optional_vars))
+            assigned = assigned_first(stmt.body, names, assigned)
+        elif isinstance(stmt, ast.Try):  # any part of the body may not run
+            assigned_first(stmt.body + stmt.orelse, names, assigned)
+            for handler in stmt.handlers:
+                assigned_first(handler.body, names, assigned | ({handler.name} if handler.name else set()))
+            assigned = assigned_first(stmt.finalbody, names, assigned)
+        elif isinstance(stmt, ast.Delete):
+            for target in stmt.targets:
+                reads(target)
+                if isinstance(target, ast.Name):
+                    assigned.discard(target.id)
+        elif isinstance(stmt, (ast.Break, ast.Continue, ast.Return, ast.Raise)):
+            reads(stmt)
+            return None
+        else:
+            for name, store in name_refs(stmt):
+                if store and not any(
+                    isinstance(n, ast.NamedExpr) and n.target.id == name for n in ast.walk(stmt)
+                ):
+                    assigned.add(name)
+                elif not store and name in names and name not in assigned:
+                    raise ValueError(name)
+            reads(stmt)
+        if assigned is None:
+            return None
+    return assigned
+
+
+def slot_base(gx: "config.GlobalInfo", node, index):
+    """'a' for 'a[index]', 'a[index][j]', .. on lists, so that iterations access different
+    slots, and nothing is resized or rehashed"""
+    while isinstance(node, ast.Subscript):
+        if isinstance(node.slice, ast.Slice) or set(
+            t[0].ident for t in gx.merged_inh.get(node.value, ())
+        ) != {"list"}:
+            return None
+        if isinstance(node.value, ast.Name):
+            if isinstance(node.slice, ast.Name) and node.slice.id == index:
+                return node.value.id
+            return None
+        node = node.value
+    return None
+
+
+def slot_aliases_ok(gx: "config.GlobalInfo", node, func, index, slots, private) -> bool:
+    """no other expression in the loop may refer to the lists written through slots, unless
+    it only reads slots of the current iteration, or cannot be the same object: fresh
+    private names, and, for a fresh slot list, formals and other fresh locals that are never
+    assigned together with it, or any expression, if the list does not escape"""
+    parent = {}
+    for child in ast.walk(func.node):
+        for sub in ast.iter_child_nodes(child):
+            parent[sub] = child
+
+    def types(expr):
+        return set(gx.merged_inh.get(expr, ()))
+
+    def slot_read(expr):  # expr[index]
+        sub = parent.get(expr)
+        return (
+            isinstance(sub, ast.Subscript)
+            and sub.value is expr
+            and isinstance(sub.slice, ast.Name)
+            and sub.slice.id == index
+        )
+
+    fresh = fresh_names(func)
+    assigned = set(name for child in ast.walk(func.node) for name, store in name_refs(child) if store)
+    together = set()  # a = b = []
+    for child in ast.walk(func.node):
+        if isinstance(child, ast.Assign) and len(child.targets) > 1:
+            names = set(t.id for t in child.targets if isinstance(t, ast.Name))
+            together.update((a, b) for a in names for b in names if a != b)
+
+    def escapes(name):
+        for child in ast.walk(func.node):
+            if isinstance(child, ast.Name) and child.id == name and isinstance(child.ctx, ast.Load):
+                up = parent.get(child)
+                if isinstance(up, ast.Subscript) and up.value is child:
+                    continue
+                if isinstance(up, (ast.Return, ast.For, ast.comprehension)) and child in (
+                    getattr(up, "value", None), getattr(up, "iter", None)
+                ):
+                    continue
+                if isinstance(up, ast.Call) and isinstance(up.func, ast.Name) and up.func.id == "len":
+                    continue
+                return True
+        return False
+
+    # the lists written: each slot list, and the nested lists along a[i][j]..
+    written = {}
+    for child in ast.walk(node):
+        if isinstance(child, ast.Subscript) and slot_base(gx, child, index) in slots:
+            base = slot_base(gx, child, index)
+            written.setdefault(base, [set(), set()])
+            level = 0 if isinstance(child.value, ast.Name) else 1
+            written[base][level].update(types(child.value))
+
+    for base, (outer, inner) in written.items():
+        private_base = base in fresh and not escapes(base)
+        for child in ast.walk(node):
+            if not isinstance(child, (ast.Name, ast.Attribute, ast.Subscript, ast.Call)):
+                continue
+            if isinstance(child, ast.Name) and (child.id == base or not isinstance(child.ctx, ast.Load)):
+                continue
+            if isinstance(child, ast.Subscript) and slot_base(gx, child, index) is not None:
+                continue
+            overlap = types(child) & (outer | inner)
+            if not overlap:
+                continue
+            if slot_read(child) and not overlap & inner:
+                continue
+            if isinstance(child, ast.Name):
+                name = child.id
+                if name in private:
+                    continue
+                if base in fresh and (name, base) not in together and (
+                    name in fresh or (name in func.formals and name not in assigned)
+                ):
+                    continue
+            if private_base:
+                continue
+            return False
+    return True
+
+
+def parallel_loop(gx: "config.GlobalInfo", node, func):
+    """for-loop over a range, marked '# shedskin: parallel', whose iterations may run in
+    any order. returns the reductions ({name: operator}) and the private names, or None.
+    names that are assigned in the loop are private to each iteration, except for
+    reductions: names that only occur as targets of += (or *=) on a scalar"""
+    if func is None or func.isGenerator or node.orelse or not isinstance(node.target, ast.Name):
+        return None
+    index = node.target.id
+
+    loop_nodes = set()  # break/continue of nested loops are fine
+    for child in ast.walk(node):
+        if isinstance(child, (ast.For, ast.While)) and child is not node:
+            loop_nodes.update(ast.walk(child))
+    for child in ast.walk(node):
+        if isinstance(child, (ast.Return, ast.Global, ast.Nonlocal, ast.Yield, ast.YieldFrom)):
+            return None
+        if isinstance(child, ast.Break) and child not in loop_nodes:
+            return None
+
+    # reductions
+    names = [n for stmt in node.body for n in ast.walk(stmt) if isinstance(n, ast.Name)]
+    augs = {}
+    for stmt in node.body:
+        for child in ast.walk(stmt):
+            if isinstance(child, ast.AugAssign) and isinstance(child.target, ast.Name):
+                augs.setdefault(child.target.id, []).append(child)
+    reductions = {}
+    for name, assigns in augs.items():
+        ops = set(type(a.op) for a in assigns)
+        var = func.vars.get(name)
+        if (
+            len(ops) == 1
+            and ops <= {ast.Add, ast.Mult}
+            and len([n for n in names if n.id == name]) == len(assigns)
+            and var is not None
+            and name not in func.formals
+            and set(t[0].ident for t in gx.merged_inh.get(var, ())) in ({"int_"}, {"float_"})
+        ):
+            reductions[name] = "+" if ops == {ast.Add} else "*"
+
+    # private names must be assigned before they are read
+    stored = set(name for stmt in [node.target] + node.body for name, store in name_refs(stmt) if store)
+    stored -= set(reductions)
+    if stored & set(func.formals) or not stored <= set(func.vars):
+        return None
+    try:  # on every path
+        assigned_first(node.body, stored - {index}, {index})
+    except ValueError:
+        return None
+
+    # .. and not read elsewhere, as the last iteration may not run last (reads under
+    # other loops or comprehensions that rebind the name are fine)
+    rebound = {}
+    for child in ast.walk(func.node):
+        if isinstance(child, (ast.For, ast.ListComp, ast.SetComp, ast.GeneratorExp, ast.DictComp)):
+            quals = [child] if isinstance(child, ast.For) else child.generators
+            for qual in quals:
+                if isinstance(qual.target, ast.Name):
+                    rebound.setdefault(qual.target.id, set()).update(ast.walk(child))
+    inside = set(ast.walk(node))
+    for child in ast.walk(func.node):
+        if (
+            isinstance(child, ast.Name)
+            and child.id in stored
+            and isinstance(child.ctx, ast.Load)
+            and child not in inside
+            and child not in rebound.get(child.id, ())
+        ):
+            return None
+
+    # no side-effects, except for writes to a[i], a[i][j], .. on lists
+    fresh = fresh_names(func) & stored
+    slots = set()
+    for stmt in node.body:
+        for child in ast.walk(stmt):
+            targets = []
+            if isinstance(child, ast.Delete):
+                if not all(pure_target(target, fresh) for target in child.targets):
+                    return None
+            elif isinstance(child, ast.Assign):
+                targets = child.targets
+            elif isinstance(child, (ast.AugAssign, ast.AnnAssign, ast.For, ast.comprehension, ast.NamedExpr)):
+                targets = [child.target]
+            elif isinstance(child, ast.withitem) and child.optional_vars:
+                targets = [child.optional_vars]
+            for target in targets:
+                base = slot_base(gx, target, index)
+                if base is not None and base not in stored:
+                    slots.add(base)
+                elif not pure_target(target, fresh):
+                    return None
+            if isinstance(child, ast.Call) and not pure_call(gx, child, fresh, set()):
+                return None
+    for stmt in node.body:  # other iterations' slots are not read
+        for child in ast.walk(stmt):
+            if (
+                isinstance(child, ast.Subscript)
+                and isinstance(child.value, ast.Name)
+                and child.value.id in slots
+                and slot_base(gx, child, index) is None
+            ):
+                return None
+            if isinstance(child, ast.Name) and child.id in slots and not any(
+                child is sub.value for sub in ast.walk(stmt) if isinstance(sub, ast.Subscript)
+            ):
+                return None
+    if not slot_aliases_ok(gx, node, func, index, slots, fresh):
+        return None
+    return reductions, stored
@@ -15,7 +15,7 @@ template<> str *array<str *>::__repr__() {
     return __add_strs(5, new str("array('"), typecode, new str("', "), repr(tostring()), new str(")"));
 }
 
-void __throw_no_char() {
+[[noreturn]] void __throw_no_char() {
     throw new TypeError(new str("array item must be char"));
 }
 
@@ -92,6 +92,66 @@ template<> template<> void *array<str *>::extend(bytes *s) {
     return NULL;
 }
 
+#ifdef __SS_BIND
+char __buffer_typechar(Py_buffer *view, bool floating, bool chars) {
+    const char *fmt = view->format ? view->format : "B";
+    if(*fmt == '@' || *fmt == '=')
+        fmt++;
+    if(!fmt[0] || fmt[1])
+        return 0;
+    char c = *fmt;
+    if(c == 'q' || c == 'Q') /* not a separate array typecode here */
+        c = (c == 'q') ? 'l' : 'L';
+    else if(c == '?')
+        c = 'B';
+    if(chars)
+        return (view->itemsize == 1 && (c == 'b' || c == 'B' || c == 'c')) ? 'c' : 0;
+    if(c == 'c' || strchr("bBhHiIlLfd", c) == NULL || (c == 'f' || c == 'd') != floating)
+        return 0;
+    if(view->itemsize != (Py_ssize_t)get_itemsize(c))
+        return 0;
+    return c;
+}
+
+struct __writeback {
+    PyObject *obj;
+    __GC_VECTOR(char) *units;
+    size_t size;
+};
+
+static thread_local std::vector<__writeback, traceable_allocator<__writeback> > __writebacks; /* keeps arrays alive */
+static thread_local bool __writebacks_active;
+
+void __register_writeback(PyObject *p, __GC_VECTOR(char) *units) {
+    if(__writebacks_active) /* only during a call, while the caller keeps p alive */
+        __writebacks.push_back({p, units, units->size()});
+}
+
+void __start_writebacks(size_t &start, bool &active) {
+    start = __writebacks.size();
+    active = __writebacks_active;
+    __writebacks_active = true;
+}
+
+void __flush_writebacks(size_t start, bool active) {
+    for(size_t i=start; i<__writebacks.size(); i++) {
+        __writeback &w = __writebacks[i];
+        if(w.units->size() != w.size)
+            continue;
+        Py_buffer view;
+        if(PyObject_GetBuffer(w.obj, &view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) == -1) {
+            PyErr_Clear();
+            continue;
+        }
+        if((size_t)view.len == w.size && w.size)
+            memcpy(view.buf, w.units->data(), w.size);
+        PyBuffer_Release(&view);
+    }
+    __writebacks.resize(start);
+    __writebacks_active = active;
+}
+#endif
+
 void __init() {
     __name__ = new str("array");
     cl_array = new class_("array");
@@ -37,6 +37,11 @@ public:
 
     template<class U> void *__init__(str *typecode_, U *iter);
 
+#ifdef __SS_BIND
+    array(PyObject *p);
+    PyObject *__to_py__();
+#endif
+
     template<class U> void *extend(U *iter);
     template<class U> void *fromlist(U *iter);
     void *fromstring(str *s);
@@ -89,6 +94,68 @@ public:
     void *__delslice__(__ss_int a, __ss_int b);
 };
 
+/* extension modules: any C-contiguous buffer with a matching item type (array.array,
+   numpy arrays, memoryviews..) is taken over with a single copy. if the caller's buffer is
+   writable, changes are copied back when the compiled call returns, as long as the length
+   did not change, so that in-place updates are visible in Python as they would be there */
+
+#ifdef __SS_BIND
+char __buffer_typechar(Py_buffer *view, bool floating, bool chars);
+void __register_writeback(PyObject *p, __GC_VECTOR(char) *units);
+void __start_writebacks(size_t &start, bool &active);
+void __flush_writebacks(size_t start, bool active);
+
+class __ss_writeback { /* scope of a compiled call; a nested scope only flushes its own buffers */
+    size_t start;
+    bool active;
+public:
+    __ss_writeback() { __start_writebacks(start, active); }
+    ~__ss_writeback() { __flush_writebacks(start, active); }
+};
+
+template<class T> array<T>::array(PyObject *p) {
+    this->__class__ = cl_array;
+    Py_buffer view;
+    if(PyObject_GetBuffer(p, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) == -1) {
+        PyErr_Clear();
+        throw new TypeError(new str("error in conversion to Shed Skin (buffer expected)"));
+    }
+    typechar = __buffer_typechar(&view, std::is_floating_point<T>::value, std::is_pointer<T>::value);
+    if(!typechar) {
+        PyBuffer_Release(&view);
+        throw new TypeError(new str("error in conversion to Shed Skin (unsupported buffer format)"));
+    }
+    typecode = __char_cache[(unsigned char)typechar];
+    itemsize = get_itemsize(typechar);
+    units.resize((size_t)view.len);
+    if(view.len)
+        memcpy(units.data(), view.buf, (size_t)view.len);
+    if(!view.readonly)
+        __register_writeback(p, &units);
+    PyBuffer_Release(&view);
+}
+
+template<class T> PyObject *array<T>::__to_py__() {
+    PyObject *mod = PyImport_ImportModule("array");
+    if(!mod)
+        return 0;
+    char code[2] = {typechar == 'c' ? 'B' : typechar, 0};
+    PyObject *arr = PyObject_CallMethod(mod, "array", "s", code);
+    Py_DECREF(mod);
+    if(!arr)
+        return 0;
+    PyObject *mem = PyMemoryView_FromMemory(units.data(), (Py_ssize_t)units.size(), PyBUF_READ);
+    PyObject *r = mem ? PyObject_CallMethod(arr, "frombytes", "O", mem) : 0;
+    Py_XDECREF(mem);
+    if(!r) {
+        Py_DECREF(arr);
+        return 0;
+    }
+    Py_DECREF(r);
+    return arr;
+}
+#endif
+
 template<class T> template<class U> void *array<T>::__init__(str *typecode_, U *iter) {
     typecode = typecode_;
     typechar = typecode_->unit[0];
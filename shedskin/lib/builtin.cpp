@@ -18,6 +18,8 @@ class_ *cl_class_, *cl_none, *cl_str_, *cl_int_, *cl_bool, *cl_float_, *cl_compl
 class_ *cl_stopiteration, *cl_assertionerror, *cl_eoferror, *cl_floatingpointerror, *cl_keyerror, *cl_indexerror, *cl_typeerror, *cl_valueerror, *cl_zerodivisionerror, *cl_keyboardinterrupt, *cl_memoryerror, *cl_nameerror, *cl_notimplementederror, *cl_oserror, *cl_overflowerror, *cl_runtimeerror, *cl_syntaxerror, *cl_systemerror, *cl_systemexit, *cl_filenotfounderror, *cl_arithmeticerror, *cl_lookuperror, *cl_exception, *cl_baseexception;
 
 str *sp, *nl, *__fmt_s, *__fmt_H, *__fmt_d;
+str *__exc_empty;
+StopIteration *__stop_iteration_exc;
 bytes *bsp;
 
 __GC_STRING ws, __fmtchars;
@@ -26,8 +28,6 @@ __GC_VECTOR(str *) __char_cache;
 __ss_bool True;
 __ss_bool False;
 
-list<str *> *__join_cache;
-list<bytes *> *__join_cache_bin;
 str *__case_swap_cache;
 
 char __str_cache[4000];
@@ -41,7 +41,14 @@ dict<void *, void *> *__ss_proxy;
 void gc_warning_handler(char *, GC_word) {}
 
 void __init() {
+#if defined(GC_THREADS) && defined(GC_VERSION_MAJOR) && (GC_VERSION_MAJOR > 8 || (GC_VERSION_MAJOR == 8 && GC_VERSION_MINOR >= 2))
+    if(getenv("SHEDSKIN_THREADS")) /* mark with as many threads as are used for parallel code */
+        GC_set_markers_count((unsigned)atoi(getenv("SHEDSKIN_THREADS")));
+#endif
     GC_INIT();
+#ifdef GC_THREADS
+    GC_allow_register_threads();
+#endif
     GC_set_warn_proc(gc_warning_handler);
 #ifdef __SS_NOGC
     GC_disable();
@@ -78,17 +85,16 @@ void __init() {
     __fmt_s = new str("%s");
     __fmt_H = new str("%H");
     __fmt_d = new str("%d");
+    __exc_empty = new str("");
 
     for(int i=0;i<256;i++) {
         char c = (char)i;
         str *charstr = new str(&c, 1);
         charstr->charcache = 1;
+        charstr->ascii = (i < 128);
         __char_cache.push_back(charstr);
     }
 
-    __join_cache = new list<str *>();
-    __join_cache_bin = new list<bytes *>();
-
     for(int i=0; i<1000; i++) {
         __str_cache[4*i] = '0' + (char)(i % 10);
         __str_cache[4*i+1] = '0' + (char)((i/10) % 10);
@@ -136,6 +142,8 @@ void __init() {
     cl_arithmeticerror = new class_("ArithmeticError");
     cl_lookuperror = new class_("LookupError");
 
+    __stop_iteration_exc = new StopIteration();
+
 }
 
 class_::class_(const char *name) {
@@ -221,6 +229,174 @@ void __ss_exit(int code) {
     throw new SystemExit(code);
 }
 
+/* threads registered by us are unregistered again when they exit, so the GC does not
+   try to stop threads that no longer exist. without GC_THREADS, there is only one thread */
+
+#ifdef GC_THREADS
+class __ss_gc_thread {
+public:
+    bool registered;
+    __ss_gc_thread() : registered(false) {}
+    ~__ss_gc_thread() {
+        if(registered)
+            GC_unregister_my_thread();
+    }
+};
+#endif
+
+void __ss_gc_register_thread() {
+#ifdef GC_THREADS
+    static thread_local __ss_gc_thread thread;
+    if(thread.registered || GC_thread_is_registered())
+        return;
+    GC_stack_base sb;
+    GC_get_stack_base(&sb);
+    GC_register_my_thread(&sb);
+    thread.registered = true;
+#endif
+}
+
+/* parallel comprehensions (--parallel): the index range is handed out in chunks to a
+   lazily started set of worker threads, and the caller helps out. results go to disjoint
+   slots, so order is preserved. the first few items are run and timed up front, so that
+   cheap loops stay serial. nested or concurrent runs are serial as well. */
+
+static thread_local bool __ss_in_parallel;
+
+class __ss_workers : public gc { /* GC-allocated, so that 'error_obj' is seen by the GC */
+public:
+    std::mutex lock, busy;
+    std::condition_variable wake, done;
+    size_t nthreads, round, active;
+    const std::function<void(size_t, size_t)> *body;
+    size_t next, end, chunk;
+    size_t error_at;
+    std::exception_ptr error;
+    BaseException *error_obj; /* keeps the exception alive until it is rethrown */
+
+    __ss_workers(size_t nthreads) : nthreads(nthreads), round(0), active(0), body(NULL), next(0), end(0), chunk(1), error_at(0), error_obj(NULL) {
+        for(size_t i=0; i<nthreads; i++)
+            std::thread(&__ss_workers::worker, this).detach();
+    }
+
+    void worker() {
+        __ss_gc_register_thread();
+        __ss_in_parallel = true;
+        size_t seen = 0;
+        for(;;) {
+            {
+                std::unique_lock<std::mutex> l(lock);
+                wake.wait(l, [&]{ return round != seen; });
+                seen = round;
+                active++;
+            }
+            work();
+            std::lock_guard<std::mutex> l(lock);
+            if(--active == 0)
+                done.notify_one();
+        }
+    }
+
+    void work() {
+        for(;;) {
+            size_t lo, hi;
+            {
+                std::lock_guard<std::mutex> l(lock);
+                if(next >= end)
+                    return;
+                lo = next;
+                hi = __SS_MIN(lo + chunk, end);
+                next = hi;
+            }
+            try {
+                (*body)(lo, hi);
+            } catch (BaseException *e) {
+                fail(lo, std::current_exception(), e);
+            } catch (...) {
+                fail(lo, std::current_exception(), NULL);
+            }
+        }
+    }
+
+    void fail(size_t at, std::exception_ptr e, BaseException *obj) { /* keep the earliest */
+        std::lock_guard<std::mutex> l(lock);
+        if(at < error_at) {
+            error_at = at;
+            error = e;
+            error_obj = obj;
+        }
+        next = end;
+    }
+};
+
+static __ss_workers *__ss_workers_pool;
+
+static size_t __ss_parallel_threads() {
+    const char *env = getenv("SHEDSKIN_THREADS");
+    if(env && atoi(env) > 0)
+        return (size_t)atoi(env);
+    return __SS_MAX((size_t)std::thread::hardware_concurrency(), (size_t)1);
+}
+
+void __ss_parallel_run(size_t n, const std::function<void(size_t, size_t)> &body) {
+    static size_t nthreads = __ss_parallel_threads();
+    const size_t probe = 8;
+    if(n <= probe || nthreads == 1 || __ss_in_parallel) {
+        body(0, n);
+        return;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    body(0, probe);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if(elapsed / probe * (double)(n - probe) < 1e-4) {
+        body(probe, n);
+        return;
+    }
+
+    static std::mutex create;
+    {
+        std::lock_guard<std::mutex> l(create);
+        if(!__ss_workers_pool)
+            __ss_workers_pool = new __ss_workers(nthreads - 1);
+    }
+    __ss_workers *w = __ss_workers_pool;
+    std::unique_lock<std::mutex> busy(w->busy, std::try_to_lock);
+    if(!busy.owns_lock()) { /* another thread is using the workers */
+        body(probe, n);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> l(w->lock);
+        w->body = &body;
+        w->next = probe;
+        w->end = n;
+        w->chunk = __SS_MAX((n - probe) / (nthreads * 4), (size_t)1);
+        w->error_at = n;
+        w->round++;
+        w->active++; /* the caller */
+    }
+    w->wake.notify_all();
+
+    __ss_in_parallel = true;
+    w->work();
+    __ss_in_parallel = false;
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> l(w->lock);
+        w->active--;
+        w->done.wait(l, [&]{ return w->active == 0; });
+        w->body = NULL;
+        error = w->error;
+        w->error = NULL;
+        w->error_obj = NULL;
+    }
+    if(error)
+        std::rethrow_exception(error);
+}
+
 /* glue */
 
 #ifdef __SS_BIND
@@ -339,6 +515,185 @@ PyObject *__ss__newobj__(PyObject *, PyObject *args, PyObject *kwargs) {
     PyObject *__new__ = PyObject_GetAttrString(cls, "__new__");
     return PyObject_Call(__new__, args, kwargs);
 }
+
+static __ss_stat *__ss_stats; /* registered at load time */
+
+__ss_stat::__ss_stat(const char *name) : name(name), calls(0), args(0), body(0), result(0), next(__ss_stats) {
+    __ss_stats = this;
+}
+
+PyObject *__ss__stats__(PyObject *, PyObject *) {
+    PyObject *d = PyDict_New();
+    for(__ss_stat *s = __ss_stats; s; s = s->next) {
+        PyObject *v = Py_BuildValue("{s:K,s:d,s:d,s:d}", "calls", s->calls, "args", s->args, "body", s->body, "result", s->result);
+        if(!v) {
+            Py_DECREF(d);
+            return NULL;
+        }
+        PyDict_SetItemString(d, s->name, v);
+        Py_DECREF(v);
+    }
+    return d;
+}
+
+/* lazy proxy types: indexing, membership and iteration go through the __ss_lazy adapter,
+   anything else works on a full conversion */
+
+struct __ss_lazy_object {
+    PyObject_HEAD
+    __ss_lazy *lazy;
+};
+
+struct __ss_lazy_iter_object {
+    PyObject_HEAD
+    __ss_lazy_iter *it;
+};
+
+PyTypeObject __ss_list_proxy_type = {PyVarObject_HEAD_INIT(NULL, 0)};
+PyTypeObject __ss_dict_proxy_type = {PyVarObject_HEAD_INIT(NULL, 0)};
+PyTypeObject __ss_set_proxy_type = {PyVarObject_HEAD_INIT(NULL, 0)};
+static PyTypeObject __ss_lazy_iter_type = {PyVarObject_HEAD_INIT(NULL, 0)};
+
+static __ss_lazy *__lazy(PyObject *self) { return ((__ss_lazy_object *)self)->lazy; }
+
+static void __lazy_dealloc(PyObject *self) {
+    __ss_proxy->__delitem__(__lazy(self));
+    PyObject_Del(self);
+}
+
+static Py_ssize_t __lazy_len(PyObject *self) { return __lazy(self)->__len(); }
+static PyObject *__lazy_item(PyObject *self, PyObject *key) { return __lazy(self)->__item(key); }
+static int __lazy_contains(PyObject *self, PyObject *key) { return __lazy(self)->__contains(key); }
+
+static PyObject *__lazy_copy(PyObject *self, PyObject *) { return __lazy(self)->__full(); }
+
+static PyObject *__lazy_call_full(PyObject *self, const char *method) {
+    PyObject *full = __lazy(self)->__full();
+    if(!full)
+        return NULL;
+    PyObject *r = PyObject_CallMethod(full, method, NULL);
+    Py_DECREF(full);
+    return r;
+}
+
+static PyObject *__lazy_keys(PyObject *self, PyObject *) { return __lazy_call_full(self, "keys"); }
+static PyObject *__lazy_values(PyObject *self, PyObject *) { return __lazy_call_full(self, "values"); }
+static PyObject *__lazy_items(PyObject *self, PyObject *) { return __lazy_call_full(self, "items"); }
+
+static PyObject *__lazy_get(PyObject *self, PyObject *args) {
+    PyObject *key, *defau = Py_None;
+    if(!PyArg_ParseTuple(args, "O|O", &key, &defau))
+        return NULL;
+    PyObject *r = __lazy(self)->__item(key);
+    if(!r && PyErr_ExceptionMatches(PyExc_KeyError)) {
+        PyErr_Clear();
+        Py_INCREF(defau);
+        return defau;
+    }
+    return r;
+}
+
+static PyObject *__lazy_repr(PyObject *self) {
+    PyObject *full = __lazy(self)->__full();
+    if(!full)
+        return NULL;
+    PyObject *r = PyObject_Repr(full);
+    Py_DECREF(full);
+    return r;
+}
+
+static PyObject *__lazy_richcompare(PyObject *self, PyObject *other, int op) {
+    PyObject *full = __lazy(self)->__full();
+    if(!full)
+        return NULL;
+    if(__ss_lazy_get(other))
+        other = __lazy(other)->__full();
+    else
+        Py_INCREF(other);
+    PyObject *r = other ? PyObject_RichCompare(full, other, op) : NULL;
+    Py_DECREF(full);
+    Py_XDECREF(other);
+    return r;
+}
+
+static PyObject *__lazy_iter(PyObject *self) {
+    __ss_lazy_iter_object *it = PyObject_New(__ss_lazy_iter_object, &__ss_lazy_iter_type);
+    if(!it)
+        return NULL;
+    it->it = __lazy(self)->__iter();
+    __ss_proxy->__setitem__(it->it, it);
+    return (PyObject *)it;
+}
+
+static void __lazy_iter_dealloc(PyObject *self) {
+    __ss_proxy->__delitem__(((__ss_lazy_iter_object *)self)->it);
+    PyObject_Del(self);
+}
+
+static PyObject *__lazy_iter_next(PyObject *self) { return ((__ss_lazy_iter_object *)self)->it->__next(); }
+
+static PyMethodDef __lazy_seq_methods[] = {
+    {"copy", __lazy_copy, METH_NOARGS, "Convert to a builtin object"},
+    {NULL}
+};
+
+static PyMethodDef __lazy_dict_methods[] = {
+    {"copy", __lazy_copy, METH_NOARGS, "Convert to a builtin object"},
+    {"keys", __lazy_keys, METH_NOARGS, ""},
+    {"values", __lazy_values, METH_NOARGS, ""},
+    {"items", __lazy_items, METH_NOARGS, ""},
+    {"get", __lazy_get, METH_VARARGS, ""},
+    {NULL}
+};
+
+static PyMappingMethods __lazy_mapping = {__lazy_len, __lazy_item, NULL};
+static PyMappingMethods __lazy_set_mapping = {__lazy_len, NULL, NULL};
+static PySequenceMethods __lazy_sequence = {__lazy_len, NULL, NULL, NULL, NULL, NULL, NULL, __lazy_contains, NULL, NULL};
+
+static void __lazy_type(PyTypeObject *type, const char *name, PyMappingMethods *mapping, PyMethodDef *methods) {
+    type->tp_name = name;
+    type->tp_basicsize = sizeof(__ss_lazy_object);
+    type->tp_flags = Py_TPFLAGS_DEFAULT;
+    type->tp_dealloc = __lazy_dealloc;
+    type->tp_as_mapping = mapping;
+    type->tp_as_sequence = &__lazy_sequence;
+    type->tp_hash = PyObject_HashNotImplemented;
+    type->tp_repr = __lazy_repr;
+    type->tp_richcompare = __lazy_richcompare;
+    type->tp_iter = __lazy_iter;
+    type->tp_methods = methods;
+    PyType_Ready(type);
+}
+
+PyObject *__ss_lazy_new(PyTypeObject *type, __ss_lazy *lazy) {
+    static bool ready;
+    if(!ready) {
+        __lazy_type(&__ss_list_proxy_type, "shedskin.list_proxy", &__lazy_mapping, __lazy_seq_methods);
+        __lazy_type(&__ss_dict_proxy_type, "shedskin.dict_proxy", &__lazy_mapping, __lazy_dict_methods);
+        __lazy_type(&__ss_set_proxy_type, "shedskin.set_proxy", &__lazy_set_mapping, __lazy_seq_methods);
+        __ss_lazy_iter_type.tp_name = "shedskin.proxy_iterator";
+        __ss_lazy_iter_type.tp_basicsize = sizeof(__ss_lazy_iter_object);
+        __ss_lazy_iter_type.tp_flags = Py_TPFLAGS_DEFAULT;
+        __ss_lazy_iter_type.tp_dealloc = __lazy_iter_dealloc;
+        __ss_lazy_iter_type.tp_iter = PyObject_SelfIter;
+        __ss_lazy_iter_type.tp_iternext = __lazy_iter_next;
+        PyType_Ready(&__ss_lazy_iter_type);
+        ready = true;
+    }
+    __ss_lazy_object *self = PyObject_New(__ss_lazy_object, type);
+    if(!self)
+        return NULL;
+    self->lazy = lazy;
+    __ss_proxy->__setitem__(lazy, self); /* keeps the container alive */
+    return (PyObject *)self;
+}
+
+__ss_lazy *__ss_lazy_get(PyObject *p) {
+    PyTypeObject *type = Py_TYPE(p);
+    if(type == &__ss_list_proxy_type || type == &__ss_dict_proxy_type || type == &__ss_set_proxy_type)
+        return __lazy(p);
+    return NULL;
+}
 #endif
 
 __ss_bool isinstance(pyobj *p, class_ *cl) {
@@ -21,6 +21,7 @@
 #include <unordered_map>
 #include <iostream>
 #include <functional>
+#include <memory>
 #include <fstream>
 #include <sstream>
 #include <cstdarg>
@@ -31,6 +32,13 @@
 #include <ctype.h>
 #include <stdint.h>
 #include <limits>
+#include <charconv>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 
 #ifndef WIN32
 #include <cxxabi.h>
@@ -126,6 +134,8 @@ using tuple = tuple2<T, T>;
 #define __GC_DEQUE(T) std::deque< T, gc_allocator< T > >
 #define __GC_STRING std::basic_string<char,std::char_traits<char>,gc_allocator<char> >
 
+#include "builtin/smallvec.hpp"
+
 extern __ss_bool True;
 extern __ss_bool False;
 
@@ -216,11 +226,13 @@ static inline __ss_bool __mbool(bool c) { __ss_bool b; b.value=c?1:0; return b;
 
 template <class T> class list : public pyseq<T> {
 public:
-    __GC_VECTOR(T) units;
+    __ss_smallvec<T> units;
 
     list();
     template <class ... Args> list(int count, Args ... args);
     template <class U> list(U *iter);
+    template <class K, class V> list(__dictiteritems<K, V> *p);
+    template <class K, class V> list(__dictitervalues<K, V> *p);
     list(list<T> *p);
     list(tuple2<T, T> *p);
     list(str *s);
@@ -260,6 +272,7 @@ public:
 
     inline T __getfast__(__ss_int i);
     inline T __getitem__(__ss_int i);
+    template<class U> inline bool __lookup__(__ss_int i, U &u);
     inline __ss_int __len__();
 
     T pop();
@@ -319,7 +332,7 @@ public:
 
 template<class T> class tuple2<T,T> : public pyseq<T> {
 public:
-    __GC_VECTOR(T) units;
+    __ss_smallvec<T> units;
 
     tuple2();
     template <class ... Args> tuple2(int count, Args ... args);
@@ -348,6 +361,7 @@ public:
 
     __ss_bool __contains__(T a);
     __ss_bool __eq__(pyobj *p);
+    __ss_int __cmp__(pyobj *p);
 
     tuple2<T,T> *__slice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s);
 
@@ -408,6 +422,7 @@ public:
     __ss_int find(bytes *s, __ss_int a, __ss_int b);
     __ss_int rfind(bytes *s, __ss_int a=0);
     __ss_int rfind(bytes *s, __ss_int a, __ss_int b);
+    __ss_int __find(bytes *s, __ss_int a, __ss_int b, bool reverse);
 
     bytes *upper();
     bytes *lower();
@@ -478,6 +493,7 @@ public:
     __ss_int pop(__ss_int i=-1);
     bytes *copy();
     void *extend(pyiter<__ss_int> *p);
+    void *extend(bytes *b);
     void *reverse();
     void *insert(__ss_int index, __ss_int item);
 
@@ -490,6 +506,7 @@ public:
     bytes *__imul__(__ss_int n);
 
     void *__setslice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s, pyiter<__ss_int> *b);
+    void *__setslice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s, bytes *b);
     void *__delete__(__ss_int x, __ss_int l, __ss_int u, __ss_int s);
 
 #ifdef __SS_BIND
@@ -498,17 +515,31 @@ public:
 #endif
 };
 
+/* sparse code point index for non-ASCII (UTF-8) strings */
+
+const size_t STR_INDEX_STRIDE = 64;
+
+class __str_index : public gc {
+public:
+    __ss_int length; /* number of code points */
+    __GC_VECTOR(size_t) offsets; /* byte offset of every STR_INDEX_STRIDE'th code point */
+};
+
 class str : public pyseq<str *> {
 protected:
 public:
     __GC_STRING unit;
     long hash;
     bool charcache;
+    std::atomic<int> ascii; /* -1: unknown, computed lazily as with hash */
+    std::atomic<__str_index *> cpindex; /* published once complete, as threads may share the str */
 
     str();
     str(const char *s);
     str(__GC_STRING s);
     str(const char *s, size_t size); /* '\0' delimiter in C */
+    str(const str &s);
+    str &operator=(const str &s);
 
     __ss_bool __contains__(str *s);
     str *strip(str *chars=0);
@@ -540,15 +571,27 @@ public:
     inline __ss_int __len__();
     str *__slice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s);
 
+    /* code point semantics for non-ASCII strings */
+    str *__slice_cp(__ss_int x, __ss_int l, __ss_int u, __ss_int s);
+    inline bool __is_ascii();
+    __str_index *__index();
+    __str_index *__build_index();
+    size_t __byte_offset(__ss_int i);
+    __ss_int __cp_offset(size_t pos);
+    inline str *__cp_at(size_t pos);
+
     list<str *> *split(str *sep=0, __ss_int maxsplit=-1);
+    str *__split_next(str *sep, __ss_int maxsplit, size_t &pos, __ss_int &splits);
     list<str *> *rsplit(str *sep=0, __ss_int maxsplit=-1);
     tuple2<str *, str *> *rpartition(str *sep);
     tuple2<str *, str *> *partition(str *sep);
     list<str *> *splitlines(__ss_int keepends = 0);
+    str *__splitlines_next(__ss_int keepends, size_t &pos);
 
     __ss_int __fixstart(size_t a, __ss_int b);
     __ss_int __checkneg(__ss_int i);
 
+    __ss_int __find(str *s, __ss_int a, __ss_int b, bool reverse);
     __ss_int find(str *s, __ss_int a=0);
     __ss_int find(str *s, __ss_int a, __ss_int b);
     __ss_int rfind(str *s, __ss_int a=0);
@@ -618,12 +661,12 @@ public:
 #endif
 };
 
-void __throw_index_out_of_range();
-void __throw_range_step_zero();
-void __throw_set_changed();
-void __throw_dict_changed();
-void __throw_slice_step_zero();
-void __throw_stop_iteration();
+[[noreturn]] void __throw_index_out_of_range();
+[[noreturn]] void __throw_range_step_zero();
+[[noreturn]] void __throw_set_changed();
+[[noreturn]] void __throw_dict_changed();
+[[noreturn]] void __throw_slice_step_zero();
+[[noreturn]] void __throw_stop_iteration();
 
 template<class K, class V> struct dictentry;
 
@@ -660,6 +703,7 @@ public:
 
     void *__setitem__(K k, V v);
     V __getitem__(K k);
+    template<class U> inline bool __lookup__(K k, U &u);
     void *__delitem__(K k);
     __ss_int __len__();
     str *__repr__();
@@ -961,6 +1005,7 @@ public:
 
     __dictiterkeys<K, V>(dict<K, V> *p);
     K __next__();
+    K __get_next();
 
     inline str *__str__() { return new str("dict_keys"); }
 };
@@ -972,6 +1017,7 @@ public:
 
     __dictitervalues<K, V>(dict<K, V> *p);
     V __next__();
+    V __get_next();
 
     inline str *__str__() { return new str("dict_values"); }
 };
@@ -983,6 +1029,7 @@ public:
 
     __dictiteritems<K, V>(dict<K, V> *p);
     tuple2<K, V> *__next__();
+    tuple2<K, V> *__get_next();
 
     inline str *__str__() { return new str("dict_items"); }
 };
@@ -1001,6 +1048,7 @@ str *input(str *msg = 0);
 
 __xrange *range(__ss_int b);
 __xrange *range(__ss_int a, __ss_int b, __ss_int s=1);
+__ss_int __range_len(__ss_int lo, __ss_int hi, __ss_int step);
 
 static inline __ss_float __portableround(__ss_float x) {
     if(x<0) return ceil(x-0.5);
@@ -1037,6 +1085,67 @@ void __init();
 void __start(void (*initfunc)());
 void __ss_exit(int code=0);
 
+/* struct-of-arrays layout for classes marked '# shedskin: soa': objects live in aligned
+   chunks, as small handles followed by one array per attribute. the index of an object
+   follows from its address, so p.x becomes a load from the x array of its chunk. a chunk
+   is only reclaimed once none of its objects is reachable. */
+
+template<class C, size_t... F> class __ss_soa {
+public:
+    static constexpr size_t bytes = 4096, align = 16;
+    static constexpr size_t count = (bytes - align * sizeof...(F)) / (sizeof(C) + (F + ... + 0));
+    static_assert(count > 0, "too many attributes for struct-of-arrays layout");
+
+    static constexpr size_t offset(size_t k) {
+        constexpr size_t sizes[] = {F..., 0};
+        size_t o = count * sizeof(C);
+        for(size_t j = 0; j < k; j++)
+            o = (o + align - 1) / align * align + count * sizes[j];
+        return (o + align - 1) / align * align;
+    }
+
+    template<class T, size_t K> static inline T &field(C *obj) {
+        constexpr size_t o = offset(K);
+        char *chunk = (char *)((uintptr_t)obj & ~(uintptr_t)(bytes - 1));
+        return ((T *)(chunk + o))[((char *)obj - chunk) / sizeof(C)];
+    }
+
+    static void *alloc() {
+        static thread_local void **chunk = (void **)GC_MALLOC_UNCOLLECTABLE(sizeof(void *)); /* keeps the current chunk alive */
+        static thread_local size_t used = count;
+        if(used == count) {
+            *chunk = GC_MEMALIGN(bytes, bytes);
+            used = 0;
+        }
+        return (char *)*chunk + sizeof(C) * used++;
+    }
+};
+
+void __ss_gc_register_thread();
+void __ss_parallel_run(size_t n, const std::function<void(size_t, size_t)> &body);
+
+template<class T> class __ss_reduction { /* partial results of a parallel loop, combined in loop order */
+    std::mutex lock;
+    std::vector<std::pair<size_t, T> > parts;
+public:
+    void add(size_t lo, T t) {
+        std::lock_guard<std::mutex> l(lock);
+        parts.push_back(std::make_pair(lo, t));
+    }
+    T sum(T t) {
+        std::sort(parts.begin(), parts.end());
+        for(size_t i=0; i<parts.size(); i++)
+            t += parts[i].second;
+        return t;
+    }
+    T product(T t) {
+        std::sort(parts.begin(), parts.end());
+        for(size_t i=0; i<parts.size(); i++)
+            t *= parts[i].second;
+        return t;
+    }
+};
+
 /* slicing */
 
 static void inline slicenr(__ss_int x, __ss_int &l, __ss_int &u, __ss_int &s, __ss_int len);
@@ -1050,9 +1159,6 @@ extern class_ *cl_str_, *cl_int_, *cl_bool, *cl_float_, *cl_complex, *cl_list, *
 
 extern __GC_VECTOR(str *) __char_cache;
 
-extern list<str *> *__join_cache;
-extern list<bytes *> *__join_cache_bin;
-
 extern file *__ss_stdin, *__ss_stdout, *__ss_stderr;
 
 /* set */
@@ -1083,6 +1189,7 @@ template<class K, class V> struct dictentry {
 
 inline __ss_int __int() { return 0; }
 __ss_int __int(str *s, __ss_int base=10);
+bool __int_parse(str *s, __ss_int &i, __ss_int base=10);
 __ss_int __int(bytes *s, __ss_int base=10);
 
 template<class T> inline __ss_int __int(T t) { return t->__int__(); }
@@ -1191,6 +1298,8 @@ template<> str *repr(long unsigned int t);
 template<> str *repr(size_t t);
 #endif
 
+str *__ascii(str *r); /* repr with non-ASCII code points escaped, as ascii() */
+
 #ifndef __SS_NOASSERT
 #define ASSERT(x, y) if(!(x)) throw new AssertionError(y);
 #else
@@ -1485,7 +1594,7 @@ template<class T> __iter<T> *__iter<T>::__iter__() {
 template<class T> T __iter<T>::__next__() { /* __get_next can be overloaded instead to avoid (slow) exception handling */
     __result = this->__get_next();
     if(__stop_iteration)
-        throw new StopIteration();
+        __throw_stop_iteration();
     return __result;
 }
 
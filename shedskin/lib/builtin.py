@@ -418,6 +418,12 @@ class str_(pyseq):
 
     def swapcase(self):
         return ''
+
+    def format(self, *args):
+        args.__str__()
+        args.__repr__()
+        return ''
+
     def center(self, width, fillchar=''):
         return ''
 
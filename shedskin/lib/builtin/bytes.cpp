@@ -36,29 +36,31 @@ __ss_int bytes::__fixstart(size_t a, __ss_int b) {
     return (__ss_int)a+b;
 }
 
-__ss_int bytes::find(bytes *s, __ss_int a) {
+__ss_int bytes::__find(bytes *s, __ss_int a, __ss_int b, bool reverse) { /* search in place, without substring copies */
     __ss_int step = 1;
-    __ss_int b = this->__len__();
+    if(a > this->__len__())
+        return -1;
     slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, this->unit.size()-(size_t)a).find(s->unit), a);
+    if(b < a)
+        return -1;
+    std::string_view view(unit.data()+a, (size_t)(b-a));
+    std::string_view needle(s->unit.data(), s->unit.size());
+    return __fixstart(reverse ? view.rfind(needle) : view.find(needle), a);
+}
+
+__ss_int bytes::find(bytes *s, __ss_int a) {
+    return __find(s, a, this->__len__(), false);
 }
 __ss_int bytes::find(bytes *s, __ss_int a, __ss_int b) {
-    __ss_int step = 1;
-    slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, (size_t)(b-a)).find(s->unit), a);
+    return __find(s, a, b, false);
 }
 
 __ss_int bytes::rfind(bytes *s, __ss_int a) {
-    __ss_int step = 1;
-    __ss_int b = this->__len__();
-    slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, this->unit.size()-(size_t)a).rfind(s->unit), a);
+    return __find(s, a, this->__len__(), true);
 }
 
 __ss_int bytes::rfind(bytes *s, __ss_int a, __ss_int b) {
-    __ss_int step = 1;
-    slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, (size_t)(b-a)).rfind(s->unit), a);
+    return __find(s, a, b, true);
 }
 
 __ss_int bytes::__checkneg(__ss_int i) {
@@ -149,7 +151,9 @@ bytes *bytes::__add__(bytes *b) {
 }
 
 bytes *bytes::__iadd__(bytes *b) {
-    unit = unit + b->unit;
+    if(frozen)
+        return __add__(b);
+    unit.append(b->unit); /* amortized growth */
     return this;
 }
 
@@ -681,6 +685,15 @@ bytes::bytes(PyObject *p) : hash(-1) {
     } else if (PyByteArray_Check(p)) {
         unit = __GC_STRING(PyByteArray_AS_STRING(p), (size_t)PyByteArray_Size(p));
 	frozen = 0;
+    } else if (PyObject_CheckBuffer(p)) { /* memoryview, array.array, numpy.. */
+        Py_buffer view;
+        if(PyObject_GetBuffer(p, &view, PyBUF_C_CONTIGUOUS) == -1) {
+            PyErr_Clear();
+            throw new TypeError(new str("error in conversion to Shed Skin (contiguous buffer expected)"));
+        }
+        unit = __GC_STRING((const char *)view.buf, (size_t)view.len);
+        frozen = view.readonly;
+        PyBuffer_Release(&view);
     } else
         throw new TypeError(new str("error in conversion to Shed Skin (bytes/bytearray expected)"));
 }
@@ -738,6 +751,11 @@ void *bytes::extend(pyiter<__ss_int> *t) {
     return NULL;
 }
 
+void *bytes::extend(bytes *b) {
+    unit.append(b->unit);
+    return NULL;
+}
+
 void *bytes::reverse() {
     __GC_STRING s(unit.rbegin(), unit.rend());
     unit = s;
@@ -753,14 +771,36 @@ void *bytes::remove(__ss_int i) {
 }
 
 void *bytes::insert(__ss_int index, __ss_int item) {
-    index = __wrap(this, index);
-    unit.insert(unit.begin()+index, (char)item);
+    __ss_int len = this->__len__();
+    if (index<0) index = len+index;
+    if (index<0) index = 0;
+    if (index>=len) index = len;
+    unit.insert((size_t)index, 1, (char)item);
     return NULL;
 }
 
 void *bytes::__setslice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s, pyiter<__ss_int> *b) {
+    bytes *t = new bytes(0);
+    t->extend(b);
+    return __setslice__(x, l, u, s, t);
+}
+
+void *bytes::__setslice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s, bytes *b) {
+    __ss_int x0 = x, l0 = l, u0 = u, s0 = s;
+    slicenr(x, l, u, s, this->__len__());
+
+    if(s == 1) { /* contiguous: replace in place */
+        if(u < l)
+            u = l;
+        if(b == this)
+            unit.replace((size_t)l, (size_t)(u-l), __GC_STRING(b->unit));
+        else
+            unit.replace((size_t)l, (size_t)(u-l), b->unit);
+        return NULL;
+    }
+
     list<__ss_int> *ll = new list<__ss_int>(this);
-    ll->__setslice__(x, l, u, s, b);
+    ll->__setslice__(x0, l0, u0, s0, new list<__ss_int>(b));
     __GC_STRING r;
     size_t len = ll->units.size();
     for(size_t i=0; i<len; i++)
@@ -770,8 +810,17 @@ void *bytes::__setslice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s, pyiter
 }
 
 void *bytes::__delete__(__ss_int x, __ss_int l, __ss_int u, __ss_int s) {
+    __ss_int x0 = x, l0 = l, u0 = u, s0 = s;
+    slicenr(x, l, u, s, this->__len__());
+
+    if(s == 1) { /* contiguous: erase in place, keeping capacity. deleting a prefix moves the rest: 'unit' is read directly throughout the library, so it cannot start at an offset */
+        if(l < u)
+            unit.erase((size_t)l, (size_t)(u-l));
+        return NULL;
+    }
+
     list<__ss_int> *ll = new list<__ss_int>(this);
-    ll->__delete__(x, l, u, s);
+    ll->__delete__(x0, l0, u0, s0);
     __GC_STRING r;
     size_t len = ll->units.size();
     for(size_t i=0; i<len; i++)
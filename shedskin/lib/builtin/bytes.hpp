@@ -39,24 +39,24 @@ template <class U> bytes *bytes::join(U *iter) {
     typename U::for_in_unit e;
     typename U::for_in_loop __3;
     U *__1;
-    __join_cache_bin->units.resize(0);
+    __GC_VECTOR(bytes *) units; /* local, as join may run on several threads or re-enter */
     total = 0;
     FOR_IN(e,iter,1,2,3)
-        __join_cache_bin->units.push_back(e);
+        units.push_back(e);
         sz = e->unit.size();
         if(sz != 1)
             only_ones = false;
         total += sz;
     END_FOR
     size_t unitsize = this->unit.size();
-    size_t elems = __join_cache_bin->units.size();
+    size_t elems = units.size();
     if(elems==1)
-        return __join_cache_bin->units[0];
+        return units[0];
     bytes *s = new bytes(frozen);
     if(unitsize == 0 and only_ones) {
         s->unit.resize(total);
         for(size_t j=0; j<elems; j++)
-            s->unit[j] = __join_cache_bin->units[j]->unit[0];
+            s->unit[j] = units[j]->unit[0];
     }
     else if(elems) {
         total += (elems-1)*unitsize;
@@ -64,7 +64,7 @@ template <class U> bytes *bytes::join(U *iter) {
         size_t tsz;
         size_t k = 0;
         for(size_t m = 0; m<elems; m++) {
-            bytes *t = __join_cache_bin->units[m];
+            bytes *t = units[m];
             tsz = t->unit.size();
             if (tsz == 1)
                 s->unit[k] = t->unit[0];
@@ -20,6 +20,16 @@ template<> inline __ss_bool __eq(__ss_bool a, __ss_bool b) { return __mbool(a ==
 template<> inline __ss_bool __eq(__ss_float a, __ss_float b) { return __mbool(a == b); }
 template<> inline __ss_bool __eq(void *a, void *b) { return __mbool(a == b); }
 
+/* comparison against literals (emitted for 'x == "GET"', 'x in ("GET", "PUT")', 'i in (1, 5, 9)') */
+
+inline __ss_bool __eq_lit(str *s, const char *lit, size_t n) {
+    return __mbool(s && s->unit.size() == n && memcmp(s->unit.data(), lit, n) == 0);
+}
+
+inline __ss_bool __in_bits(__ss_int i, unsigned long long bits) {
+    return __mbool(i >= 0 && i < 64 && ((bits >> i) & 1));
+}
+
 /* ne */
 
 template<class T> inline __ss_bool __ne(T a, T b) { return ((a&&b)?(a->__ne__(b)):__mbool(a!=b)); }
@@ -133,6 +143,49 @@ template<> inline __ss_int __cmp(void *a, void *b) {
     return 0;
 }
 
+/* tuples: compare fields inline for the static element types, instead of virtual __eq__/__cmp__ */
+
+template<class A, class B> inline __ss_bool __eq(tuple2<A, B> *a, tuple2<A, B> *b) {
+    if(a == b) return True;
+    if(!a || !b) return False;
+    return __mbool(__eq(a->first, b->first) && __eq(a->second, b->second));
+}
+
+template<class T> inline __ss_bool __eq(tuple2<T, T> *a, tuple2<T, T> *b) {
+    if(a == b) return True;
+    if(!a || !b) return False;
+    size_t sz = a->units.size();
+    if(b->units.size() != sz)
+        return False;
+    for(size_t i=0; i<sz; i++)
+        if(!__eq(a->units[i], b->units[i]))
+            return False;
+    return True;
+}
+
+template<class A, class B> inline __ss_int __cmp(tuple2<A, B> *a, tuple2<A, B> *b) {
+    if (!a) return -1;
+    if (!b) return 1;
+    if(__ss_int c = __cmp(a->first, b->first)) return c;
+    return __cmp(a->second, b->second);
+}
+
+template<class T> inline __ss_int __cmp(tuple2<T, T> *a, tuple2<T, T> *b) {
+    if (!a) return -1;
+    if (!b) return 1;
+    size_t la = a->units.size(), lb = b->units.size();
+    size_t mnm = la < lb ? la : lb;
+    for(size_t i = 0; i < mnm; i++)
+        if(__ss_int c = __cmp(a->units[i], b->units[i]))
+            return c;
+    return (la < lb) ? -1 : (la > lb);
+}
+
+template<class A, class B> inline __ss_bool __lt(tuple2<A, B> *a, tuple2<A, B> *b) { return __mbool(__cmp(a, b) == -1); }
+template<class A, class B> inline __ss_bool __le(tuple2<A, B> *a, tuple2<A, B> *b) { return __mbool(__cmp(a, b) != 1); }
+template<class A, class B> inline __ss_bool __gt(tuple2<A, B> *a, tuple2<A, B> *b) { return __mbool(__cmp(a, b) == 1); }
+template<class A, class B> inline __ss_bool __ge(tuple2<A, B> *a, tuple2<A, B> *b) { return __mbool(__cmp(a, b) != -1); }
+
 template<class T> __ss_int cpp_cmp(T a, T b) {
     return __cmp(a, b) == -1;
 }
@@ -171,7 +224,7 @@ public:
 template<class T> class ss_eq {
     public:
         bool operator()(const T a, const T b) const {
-            return __eq<T>(a, b);
+            return __eq(a, b);
         }
 
 };
@@ -42,10 +42,14 @@ template<class K, class V> dict<K, V>::dict(dict<K, V> *p)  {
 
 #ifdef __SS_BIND
 template<class K, class V> dict<K, V>::dict(PyObject *p) {
+    this->__class__ = cl_dict;
+    if(dict<K, V> *d = __ss_lazy_target<dict<K, V> >(p)) {
+        gcd = d->gcd;
+        return;
+    }
     if(!PyDict_Check(p))
         throw new TypeError(new str("error in conversion to Shed Skin (dictionary expected)"));
 
-    this->__class__ = cl_dict;
     PyObject *key, *value;
 
     PyObject *iter = PyObject_GetIter(p);
@@ -70,6 +74,65 @@ template<class K, class V> PyObject *dict<K, V>::__to_py__() {
 
    return p;
 }
+
+template<class K, class V> class __ss_lazy_dict_iter : public __ss_lazy_iter {
+public:
+    dict<K, V> *target;
+    __GC_VECTOR(K) keys; /* snapshot: compiled code may still change (and rehash) the dict */
+    size_t i;
+
+    __ss_lazy_dict_iter(dict<K, V> *d) : target(d), i(0) {
+        keys.reserve(d->gcd.size());
+        for(const auto &entry : d->gcd)
+            keys.push_back(entry.first);
+    }
+    PyObject *__next() {
+        if(target->gcd.size() != keys.size()) {
+            PyErr_SetString(PyExc_RuntimeError, "dictionary changed size during iteration");
+            return NULL;
+        }
+        if(i >= keys.size())
+            return NULL;
+        return __to_py_lazy(keys[i++]);
+    }
+};
+
+template<class K, class V> class __ss_lazy_dict : public __ss_lazy_of<dict<K, V> > {
+public:
+    __ss_lazy_dict(dict<K, V> *d) : __ss_lazy_of<dict<K, V> >(d) {}
+
+    Py_ssize_t __len() { return (Py_ssize_t)this->target->gcd.size(); }
+
+    typename __GC_DICT<K, V>::iterator __find(PyObject *key) {
+        try {
+            return this->target->gcd.find(__to_ss<K>(key));
+        } catch (Exception *) { /* wrong key type */
+            PyErr_Clear();
+            return this->target->gcd.end();
+        }
+    }
+
+    PyObject *__item(PyObject *key) {
+        typename __GC_DICT<K, V>::iterator it = __find(key);
+        if(it == this->target->gcd.end()) {
+            PyErr_SetObject(PyExc_KeyError, key);
+            return NULL;
+        }
+        return __to_py_lazy(it->second);
+    }
+
+    int __contains(PyObject *key) { return __find(key) != this->target->gcd.end(); }
+
+    __ss_lazy_iter *__iter() { return new __ss_lazy_dict_iter<K, V>(this->target); }
+};
+
+template<class K, class V> PyObject *__to_py_lazy(dict<K, V> *d) {
+    if(!d) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    return __ss_lazy_new(&__ss_dict_proxy_type, new __ss_lazy_dict<K, V>(d));
+}
 #endif
 
 template<class K, class V> __ss_bool dict<K,V>::__eq__(pyobj *p) {
@@ -127,15 +190,25 @@ template<> __ss_float __none();
 template <class K, class V> V dict<K,V>::__getitem__(K key) {
     typename __GC_DICT<K, V>::iterator it = gcd.find(key);
     if (it == gcd.end())
-        throw new KeyError(repr(key));
+        throw new __KeyError<K>(key);
     else
         return (*it).second;
 }
 
+/* non-throwing lookup for try/except KeyError around a subscript */
+
+template <class K, class V> template<class U> inline bool dict<K,V>::__lookup__(K key, U &u) {
+    typename __GC_DICT<K, V>::iterator it = gcd.find(key);
+    if (it == gcd.end())
+        return false;
+    u = (*it).second;
+    return true;
+}
+
 template<class K, class V> void *dict<K,V>::__addtoitem__(K key, V value) {
     typename __GC_DICT<K, V>::iterator it = gcd.find(key);
     if (it == gcd.end())
-        throw new KeyError(repr(key));
+        throw new __KeyError<K>(key);
     else
         (*it).second = __add((*it).second, value);
 
@@ -172,7 +245,7 @@ template <class K, class V> V dict<K,V>::setdefault(K key, V value)
 template <class K, class V> void *dict<K,V>::__delitem__(K key) {
     typename __GC_DICT<K, V>::iterator it = gcd.find(key);
     if (it == gcd.end())
-        throw new KeyError(repr(key));
+        throw new __KeyError<K>(key);
     else
         gcd.erase(it);
 
@@ -182,7 +255,7 @@ template <class K, class V> void *dict<K,V>::__delitem__(K key) {
 template<class K, class V> V dict<K,V>::pop(K key) {
     typename __GC_DICT<K, V>::iterator it = gcd.find(key);
     if (it == gcd.end())
-        throw new KeyError(repr(key));
+        throw new __KeyError<K>(key);
     else {
         V v = (*it).second;
         gcd.erase(it);
@@ -332,6 +405,78 @@ template<class K, class V> tuple2<K, V> *__dictiteritems<K, V>::__next__() {
     return t;
 }
 
+/* __get_next avoids throwing StopIteration at the end of each FOR_IN */
+
+template<class K, class V> K __dictiterkeys<K, V>::__get_next() {
+    if(it == p->gcd.end()) {
+        this->__stop_iteration = true;
+        return __zero<K>();
+    }
+    return (*it++).first;
+}
+
+template<class K, class V> V __dictitervalues<K, V>::__get_next() {
+    if(it == p->gcd.end()) {
+        this->__stop_iteration = true;
+        return __zero<V>();
+    }
+    return (*it++).second;
+}
+
+template<class K, class V> tuple2<K, V> *__dictiteritems<K, V>::__get_next() {
+    if(it == p->gcd.end()) {
+        this->__stop_iteration = true;
+        return 0;
+    }
+    tuple2<K, V> *t = new tuple2<K, V>(2, (*it).first, (*it).second);
+    it++;
+    return t;
+}
+
+/* remaining items as pairs allocated in blocks, instead of one allocation per entry. a block is only
+   freed once none of its pairs are reachable, so blocks are kept small: one surviving pair (say, the
+   first element of sorted(d.items())) keeps at most DICT_PAIR_BLOCK pairs alive */
+
+const size_t DICT_PAIR_BLOCK = 64;
+
+template<class K, class V, class U> void __dict_pairs(__dictiteritems<K, V> *items, U &units) {
+    typename __GC_DICT<K, V>::iterator end = items->p->gcd.end();
+    size_t n = items->it == items->p->gcd.begin() ? items->p->gcd.size() : (size_t)std::distance(items->it, end);
+    if(!n)
+        return;
+    tuple2<K, V> *block = 0;
+    size_t left = 0;
+    units.reserve(units.size()+n);
+    for(; items->it != end; items->it++, block++, left--) {
+        if(!left) {
+            left = __SS_MIN(n, DICT_PAIR_BLOCK);
+            block = new tuple2<K, V>[left];
+            n -= left;
+        }
+        block->__init2__((*items->it).first, (*items->it).second);
+        units.push_back(block);
+    }
+}
+
+template<class K, class V> int __cmp_pair(const std::pair<const K, V> &a, const std::pair<const K, V> &b) {
+    int c = __cmp(a.first, b.first);
+    if(c)
+        return c;
+    return __cmp(a.second, b.second);
+}
+
+template<class T> template<class K, class V> list<T>::list(__dictiteritems<K, V> *p) {
+    this->__class__ = cl_list;
+    __dict_pairs(p, this->units);
+}
+
+template<class T> template<class K, class V> list<T>::list(__dictitervalues<K, V> *p) {
+    this->__class__ = cl_list;
+    this->units.reserve(p->p->gcd.size());
+    for(; p->it != p->p->gcd.end(); p->it++)
+        this->units.push_back((*p->it).second);
+}
+
 /* dict.fromkeys */
 
 namespace __dict__ {
@@ -30,21 +30,28 @@ str *FileNotFoundError::__repr__() {
     return __add_strs(5, new str("FileNotFoundError("), __str(__ss_errno), new str(", '"), strerror, new str("')"));
 }
 
+/* messages are allocated once, the exception objects themselves may be kept by the caller */
+
 void __throw_index_out_of_range() {
-    throw new IndexError(new str("index out of range"));
+    static str *msg = new str("index out of range");
+    throw new IndexError(msg);
 }
 void __throw_range_step_zero() {
-    throw new ValueError(new str("range() step argument must not be zero"));
+    static str *msg = new str("range() step argument must not be zero");
+    throw new ValueError(msg);
 }
 void __throw_set_changed() {
-    throw new RuntimeError(new str("set changed size during iteration"));
+    static str *msg = new str("set changed size during iteration");
+    throw new RuntimeError(msg);
 }
 void __throw_dict_changed() {
-    throw new RuntimeError(new str("dict changed size during iteration"));
+    static str *msg = new str("dict changed size during iteration");
+    throw new RuntimeError(msg);
 }
 void __throw_slice_step_zero() {
-    throw new ValueError(new str("slice step cannot be zero"));
+    static str *msg = new str("slice step cannot be zero");
+    throw new ValueError(msg);
 }
 void __throw_stop_iteration() {
-    throw new StopIteration();
+    throw __stop_iteration_exc;
 }
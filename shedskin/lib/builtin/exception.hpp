@@ -95,6 +95,8 @@ static void print_traceback(FILE *out)
 
 extern class_ *cl_stopiteration, *cl_assertionerror, *cl_eoferror, *cl_floatingpointerror, *cl_keyerror, *cl_indexerror, *cl_typeerror, *cl_valueerror, *cl_zerodivisionerror, *cl_keyboardinterrupt, *cl_memoryerror, *cl_nameerror, *cl_notimplementederror, *cl_oserror, *cl_overflowerror, *cl_runtimeerror, *cl_syntaxerror, *cl_systemerror, *cl_systemexit, *cl_arithmeticerror, *cl_lookuperror, *cl_exception, *cl_baseexception;
 
+extern str *__exc_empty; /* shared default message, strings are immutable */
+
 class BaseException : public pyobj {
 public:
     str *message;
@@ -107,13 +109,13 @@ public:
         if(msg)
             message = msg;
         else
-            message = new str("");
+            message = __exc_empty;
     }
     void __init__(void *) { /* XXX test 148 */
-        message = new str("");
+        message = __exc_empty;
     }
     str *__repr__() {
-        return __add_strs(4, this->__class__->__name__, new str("('"), message, new str("')"));
+        return __add_strs(4, this->__class__->__name__, new str("('"), this->__str__(), new str("')"));
     }
     str *__str__() {
         return message;
@@ -134,6 +136,8 @@ public:
     StopIteration(str *msg=0) : Exception(msg) { this->__class__ = cl_stopiteration; }
 };
 
+extern StopIteration *__stop_iteration_exc; /* preallocated, for internal end-of-iteration throws */
+
 class AssertionError : public Exception {
 public:
     AssertionError(str *msg=0) : Exception(msg) { this->__class__ = cl_assertionerror; }
@@ -182,6 +186,21 @@ public:
 #endif
 };
 
+template<class K> class __KeyError : public KeyError { /* formats the missing key only when printed */
+public:
+    K key;
+    bool formatted;
+
+    __KeyError(K k) : KeyError(), key(k), formatted(false) {}
+    str *__str__() {
+        if(!formatted) {
+            message = repr(key);
+            formatted = true;
+        }
+        return message;
+    }
+};
+
 class IndexError : public LookupError {
 public:
     IndexError(str *msg=0) : LookupError(msg) { this->__class__ = cl_indexerror; }
@@ -12,6 +12,7 @@ template<> __ss_int __to_ss(PyObject *p);
 template<> __ss_bool __to_ss(PyObject *p);
 template<> __ss_float __to_ss(PyObject *p);
 template<> void *__to_ss(PyObject *p);
+template<> str *__to_ss(PyObject *p);
 
 template<class T> PyObject *__to_py(T t) {
     if(!t) {
@@ -39,6 +40,148 @@ template<> PyObject *__to_py(void *);
 extern dict<void *, void *> *__ss_proxy;
 #endif
 
+/* lazy proxies (shedskin translate -e --proxy): a list, dict or set result is returned as a
+   read-only proxy object over the live container, converting elements only on access. the
+   container is kept alive through __ss_proxy for as long as the proxy exists */
+
+#ifdef __SS_BIND
+class __ss_lazy_iter : public gc {
+public:
+    virtual PyObject *__next() = 0; /* NULL when exhausted, or with an exception set */
+};
+
+class __ss_lazy : public gc {
+public:
+    virtual Py_ssize_t __len() = 0;
+    virtual PyObject *__item(PyObject *key) = 0;
+    virtual int __contains(PyObject *key) = 0;
+    virtual __ss_lazy_iter *__iter() = 0;
+    virtual PyObject *__full() = 0;
+};
+
+template<class C> class __ss_lazy_of : public __ss_lazy {
+public:
+    C *target;
+    __ss_lazy_of(C *c) : target(c) {}
+    PyObject *__full() { return target->__to_py__(); }
+};
+
+extern PyTypeObject __ss_list_proxy_type, __ss_dict_proxy_type, __ss_set_proxy_type;
+PyObject *__ss_lazy_new(PyTypeObject *type, __ss_lazy *lazy);
+__ss_lazy *__ss_lazy_get(PyObject *p);
+
+template<class C> C *__ss_lazy_target(PyObject *p) { /* passing a proxy back in */
+    __ss_lazy_of<C> *l = dynamic_cast<__ss_lazy_of<C> *>(__ss_lazy_get(p));
+    return l ? l->target : NULL;
+}
+
+template<class T> PyObject *__to_py_lazy(T t) { return __to_py(t); }
+template<class T> PyObject *__to_py_lazy(list<T> *l);
+template<class K, class V> PyObject *__to_py_lazy(dict<K, V> *d);
+template<class T> PyObject *__to_py_lazy(set<T> *s);
+#endif
+
+/* numbers from a C-contiguous buffer (array.array, numpy arrays..), without creating
+   a Python object per element */
+
+#ifdef __SS_BIND
+#define __SS_FROM_BUFFER(C) \
+    if(view.itemsize != sizeof(C)) \
+        break; \
+    for(size_t i=0; i<n; i++) { \
+        C x; \
+        memcpy(&x, buf+i*sizeof(C), sizeof(C)); \
+        units[i] = (E)x; \
+    } \
+    ok = true; \
+    break;
+
+template<class E, class U> bool __numbers_from_buffer(PyObject *p, U &units, bool floating) {
+    Py_buffer view;
+    if(!PyObject_CheckBuffer(p) || PyObject_GetBuffer(p, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) == -1) {
+        PyErr_Clear();
+        return false;
+    }
+    const char *fmt = view.format ? view.format : "B";
+    if(*fmt == '@' || *fmt == '=')
+        fmt++;
+    const char *buf = (const char *)view.buf;
+    size_t n = view.itemsize ? (size_t)(view.len / view.itemsize) : 0;
+    bool ok = false;
+    if(fmt[0] && !fmt[1]) {
+        units.resize(n);
+        switch(fmt[0]) {
+            case 'b': __SS_FROM_BUFFER(signed char)
+            case '?':
+            case 'B': __SS_FROM_BUFFER(unsigned char)
+            case 'h': __SS_FROM_BUFFER(short)
+            case 'H': __SS_FROM_BUFFER(unsigned short)
+            case 'i': __SS_FROM_BUFFER(int)
+            case 'I': __SS_FROM_BUFFER(unsigned int)
+            case 'l': __SS_FROM_BUFFER(long)
+            case 'L': __SS_FROM_BUFFER(unsigned long)
+            case 'q': __SS_FROM_BUFFER(long long)
+            case 'Q': __SS_FROM_BUFFER(unsigned long long)
+            case 'f': if(floating) { __SS_FROM_BUFFER(float) } break;
+            case 'd': if(floating) { __SS_FROM_BUFFER(double) } break;
+        }
+    }
+    PyBuffer_Release(&view);
+    return ok;
+}
+#undef __SS_FROM_BUFFER
+
+template<class U> bool __units_from_buffer(PyObject *, U &) { return false; }
+template<class A> bool __units_from_buffer(PyObject *p, __ss_smallvec<__ss_int, A> &units) { return __numbers_from_buffer<__ss_int>(p, units, false); }
+template<class A> bool __units_from_buffer(PyObject *p, __ss_smallvec<__ss_float, A> &units) { return __numbers_from_buffer<__ss_float>(p, units, true); }
+#endif
+
+/* batch calls (shedskin translate -e --batch): f_many(iterable) calls f for each item, or
+   each tuple of arguments, without going through the Python calling convention. a numeric
+   buffer is read without creating a Python object per item */
+
+#ifdef __SS_BIND
+template<class F> PyObject *__ss_many(PyObject *arg, Py_ssize_t arity, F f) {
+    PyObject *seq = PySequence_Fast(arg, "iterable expected");
+    if(!seq)
+        return 0;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    PyObject *result = PyList_New(n);
+    try {
+        for(Py_ssize_t i=0; i<n; i++) {
+            PyObject *const *args = &items[i];
+            if(arity > 1) {
+                if(!PyTuple_Check(items[i]) || PyTuple_GET_SIZE(items[i]) != arity)
+                    throw new TypeError(new str("argument tuple of the right length expected"));
+                args = ((PyTupleObject *)items[i])->ob_item;
+            }
+            PyObject *r = f(args);
+            if(!r)
+                throw new TypeError(new str("error in conversion to Python"));
+            PyList_SET_ITEM(result, i, r);
+        }
+    } catch (Exception *) {
+        Py_DECREF(result);
+        Py_DECREF(seq);
+        throw;
+    }
+    Py_DECREF(seq);
+    return result;
+}
+
+template<class T, class F> PyObject *__ss_many1(PyObject *arg, F f) {
+    __ss_smallvec<T> units;
+    if(__units_from_buffer(arg, units)) {
+        PyObject *result = PyList_New((Py_ssize_t)units.size());
+        for(size_t i=0; i<units.size(); i++)
+            PyList_SET_ITEM(result, (Py_ssize_t)i, __to_py(f(units[i])));
+        return result;
+    }
+    return __ss_many(arg, 1, [&](PyObject *const *args) { return __to_py(f(__to_ss<T>(args[0]))); });
+}
+#endif
+
 /* binding args */
 
 #ifdef __SS_BIND
@@ -54,9 +197,72 @@ template<class T> T __ss_arg(const char *name, int pos, int has_default, T defau
     else
         throw new TypeError(new str("missing argument"));
 }
+
+/* vectorcall (METH_FASTCALL | METH_KEYWORDS) variant: positional arguments are read
+   directly from the argument vector, keyword names are compared by identity first,
+   as CPython interns them (and so do the wrappers for the names they pass in) */
+
+template<class T> T __ss_fastarg(PyObject *name, int pos, int has_default, T default_value, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
+    if (pos < nargs)
+        return __to_ss<T>(args[pos]);
+    if (kwnames) {
+        Py_ssize_t nrofkw = PyTuple_GET_SIZE(kwnames);
+        for (Py_ssize_t i = 0; i < nrofkw; i++)
+            if (PyTuple_GET_ITEM(kwnames, i) == name)
+                return __to_ss<T>(args[nargs+i]);
+        for (Py_ssize_t i = 0; i < nrofkw; i++)
+            if (PyUnicode_Compare(PyTuple_GET_ITEM(kwnames, i), name) == 0)
+                return __to_ss<T>(args[nargs+i]);
+    }
+    if (has_default)
+        return default_value;
+    throw new TypeError(new str("missing argument"));
+}
 #endif
 
 #ifdef __SS_BIND
 PyObject *__ss__newobj__(PyObject *, PyObject *args, PyObject *kwargs);
 #endif
 
+/* call statistics (shedskin translate -e --stats): per exported function, the number of
+   calls and the time spent converting arguments, in compiled code and converting the
+   result, as returned by __ss_stats__() in the module */
+
+#ifdef __SS_BIND
+class __ss_stat {
+public:
+    const char *name;
+    unsigned long long calls;
+    double args, body, result;
+    __ss_stat *next;
+
+    __ss_stat(const char *name);
+};
+
+class __ss_timer {
+    std::chrono::steady_clock::time_point last;
+public:
+    __ss_timer(__ss_stat &stat) : last(std::chrono::steady_clock::now()) { stat.calls++; }
+    void lap(double &total) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        total += std::chrono::duration<double>(now - last).count();
+        last = now;
+    }
+};
+
+PyObject *__ss__stats__(PyObject *, PyObject *);
+#endif
+
+/* releasing the GIL around compiled calls ('# shedskin: nogil' or --nogil). the calling
+   thread was registered with the GC on entering the wrapper, before its arguments were
+   converted. the GIL is taken back on return as well as on exceptions */
+
+#ifdef __SS_BIND
+class __ss_nogil {
+    PyThreadState *state;
+public:
+    __ss_nogil() { state = PyEval_SaveThread(); }
+    ~__ss_nogil() { PyEval_RestoreThread(state); }
+};
+#endif
+
@@ -138,7 +138,7 @@ str *file::readline(int n) {
     return new str(&__read_cache[0], __read_cache.size());
 }
 
-static void __throw_io_error() {
+[[noreturn]] static void __throw_io_error() {
     throw new OSError();
 }
 
@@ -251,10 +251,10 @@ __iter<str *> *file::__iter__() {
 
 str *file::__next__() {
     if(__eof())
-        throw new StopIteration();
+        __throw_stop_iteration();
     str *line = readline();
     if(__eof() and !len(line))
-        throw new StopIteration();
+        __throw_stop_iteration();
     return line;
 }
 
@@ -481,10 +481,10 @@ __iter<bytes *> *file_binary::__iter__() {
 
 bytes *file_binary::__next__() {
     if(__eof())
-        throw new StopIteration();
+        __throw_stop_iteration();
     bytes *line = readline();
     if(__eof() and !len(line))
-        throw new StopIteration();
+        __throw_stop_iteration();
     return line;
 }
 
@@ -81,3 +81,329 @@ str *__escape_bytes(pyobj *p) {
 
     return new str(ss.str().c_str());
 }
+
+/* str.format, f-string format specs */
+
+__fmt_spec::__fmt_spec() : align(0), sign(0), alt(false), zero(false), grouping(0), width(-1), precision(-1), type(0) {
+    fill[0] = ' ';
+    fill[1] = '\0';
+}
+
+__fmt_spec::__fmt_spec(const char *fill_, char align_, char sign_, bool alt_, bool zero_, __ss_int width_, char grouping_, __ss_int precision_, char type_) : align(align_), sign(sign_), alt(alt_), zero(zero_), grouping(grouping_), width(width_), precision(precision_), type(type_) {
+    strncpy(fill, fill_, 4);
+    fill[4] = '\0';
+}
+
+static inline bool __fmt_oneof(char c, const char *chars) {
+    return c && strchr(chars, c);
+}
+
+static size_t __fmt_digits(const char *s, size_t n, size_t &i, __ss_int &value) {
+    size_t start = i;
+    value = 0;
+    while(i < n && s[i] >= '0' && s[i] <= '9')
+        value = value*10 + (s[i++]-'0');
+    return i-start;
+}
+
+__fmt_spec __fmt_parse_spec(const char *s, size_t n) {
+    __fmt_spec spec;
+    size_t i = 0;
+
+    size_t w = n ? __utf8_width(s, n, 0) : 0;
+    if(n > w && __fmt_oneof(s[w], "<>=^")) {
+        memcpy(spec.fill, s, w);
+        spec.fill[w] = '\0';
+        spec.align = s[w];
+        i = w+1;
+    } else if(n && __fmt_oneof(s[0], "<>=^")) {
+        spec.align = s[0];
+        i = 1;
+    }
+
+    if(i < n && __fmt_oneof(s[i], "+- "))
+        spec.sign = s[i++];
+    if(i < n && s[i] == '#') {
+        spec.alt = true;
+        i++;
+    }
+    if(i < n && s[i] == '0') {
+        spec.zero = true;
+        i++;
+    }
+    __ss_int value;
+    if(__fmt_digits(s, n, i, value))
+        spec.width = value;
+    if(i < n && __fmt_oneof(s[i], ",_"))
+        spec.grouping = s[i++];
+    if(i < n && s[i] == '.') {
+        i++;
+        if(!__fmt_digits(s, n, i, value))
+            throw new ValueError(new str("Format specifier missing precision"));
+        spec.precision = value;
+    }
+    if(i < n)
+        spec.type = s[i++];
+    if(i != n)
+        throw new ValueError(new str("Invalid format specifier"));
+
+    return spec;
+}
+
+__fmt_spec __fmt_parse_spec(str *s) {
+    return __fmt_parse_spec(s->unit.data(), s->unit.size());
+}
+
+static void __fmt_group(std::string &digits, size_t start, size_t end, char sep, size_t every) { /* insert separators in digits[start:end] */
+    std::string r;
+    size_t len = end-start;
+    for(size_t i=0; i<len; i++) {
+        if(i && (len-i) % every == 0)
+            r += sep;
+        r += digits[start+i];
+    }
+    digits.replace(start, len, r);
+}
+
+static void __fmt_align(str *result, const std::string &prefix, const char *body, size_t size, size_t cplen, const __fmt_spec &spec, char align) {
+    const char *fill = spec.fill;
+    if(spec.zero && !spec.align) {
+        fill = "0";
+        if(align == '>')
+            align = '=';
+    }
+    if(spec.align)
+        align = spec.align;
+
+    size_t pad = 0;
+    cplen += prefix.size();
+    if(spec.width > 0 && (size_t)spec.width > cplen)
+        pad = (size_t)spec.width - cplen;
+
+    size_t left = 0;
+    if(align == '>' or align == '=')
+        left = pad;
+    else if(align == '^')
+        left = pad/2;
+
+    __GC_STRING &out = result->unit;
+    if(align != '=')
+        for(size_t k=0; k<left; k++)
+            out += fill;
+    out += prefix;
+    if(align == '=')
+        for(size_t k=0; k<left; k++)
+            out += fill;
+    out.append(body, size);
+    for(size_t k=left; k<pad; k++)
+        out += fill;
+}
+
+static std::string __fmt_sign(bool neg, const __fmt_spec &spec) {
+    if(neg)
+        return "-";
+    if(spec.sign == '+' or spec.sign == ' ')
+        return std::string(1, spec.sign);
+    return "";
+}
+
+void __fmt_str(str *result, str *s, const __fmt_spec &spec) {
+    if(spec.type && spec.type != 's')
+        throw new ValueError(__add_strs(3, new str("Unknown format code '"), new str(std::string(1, spec.type).c_str()), new str("' for object of type 'str'")));
+    if(spec.sign)
+        throw new ValueError(new str("Sign not allowed in string format specifier"));
+    if(spec.align == '=')
+        throw new ValueError(new str("'=' alignment not allowed in string format specifier"));
+
+    size_t size = s->unit.size();
+    size_t cplen = (size_t)s->__len__();
+    if(spec.precision != -1 && (size_t)spec.precision < cplen) {
+        size = s->__byte_offset(spec.precision);
+        cplen = (size_t)spec.precision;
+    }
+    __fmt_align(result, "", s->unit.data(), size, cplen, spec, '<');
+}
+
+void __fmt_float(str *result, __ss_float value, const __fmt_spec &spec) {
+    char type = spec.type;
+    __ss_int precision = spec.precision;
+    bool neg = std::signbit(value) && !std::isnan(value);
+    __ss_float mag = std::fabs(value);
+    std::string digits;
+
+    if(!type && precision == -1)
+        digits = __str(mag)->unit.c_str();
+    else {
+        std::chars_format fmt;
+        switch(type) {
+            case 'f': case 'F': case '%':
+                fmt = std::chars_format::fixed;
+                if(type == '%')
+                    mag *= 100;
+                break;
+            case 'e': case 'E':
+                fmt = std::chars_format::scientific;
+                break;
+            case 'g': case 'G': case 'n': case 0:
+                fmt = std::chars_format::general;
+                if(precision == 0)
+                    precision = 1;
+                break;
+            default:
+                throw new ValueError(__add_strs(3, new str("Unknown format code '"), new str(std::string(1, type).c_str()), new str("' for object of type 'float'")));
+        }
+        if(precision == -1)
+            precision = 6;
+        digits.resize(330 + (size_t)precision);
+        std::to_chars_result r = std::to_chars(digits.data(), digits.data()+digits.size(), mag, fmt, (int)precision);
+        digits.resize((size_t)(r.ptr-digits.data()));
+        if(type == 0 && std::isfinite(mag) && digits.find_first_of(".e") == std::string::npos)
+            digits += ".0";
+        if(type == '%')
+            digits += '%';
+        if(type == 'F' or type == 'E' or type == 'G')
+            for(size_t i=0; i<digits.size(); i++)
+                digits[i] = (char)toupper(digits[i]);
+    }
+
+    if(spec.grouping && std::isfinite(mag))
+        __fmt_group(digits, 0, digits.find_first_not_of("0123456789"), spec.grouping, 3);
+
+    __fmt_align(result, __fmt_sign(neg, spec), digits.data(), digits.size(), digits.size(), spec, '>');
+}
+
+void __fmt_int(str *result, __ss_int value, const __fmt_spec &spec) {
+    char type = spec.type;
+    int base = 10;
+    std::string prefix;
+
+    switch(type) {
+        case 0: case 'd': case 'n':
+            break;
+        case 'b':
+            base = 2; prefix = "0b";
+            break;
+        case 'o':
+            base = 8; prefix = "0o";
+            break;
+        case 'x':
+            base = 16; prefix = "0x";
+            break;
+        case 'X':
+            base = 16; prefix = "0X";
+            break;
+        case 'c': {
+            str *c = chr(value);
+            __fmt_align(result, "", c->unit.data(), c->unit.size(), 1, spec, '>');
+            return;
+        }
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case '%':
+            __fmt_float(result, (__ss_float)value, spec);
+            return;
+        default:
+            throw new ValueError(__add_strs(3, new str("Unknown format code '"), new str(std::string(1, type).c_str()), new str("' for object of type 'int'")));
+    }
+    if(spec.precision != -1)
+        throw new ValueError(new str("Precision not allowed in integer format specifier"));
+
+    unsigned long long mag = value < 0 ? 0ULL-(unsigned long long)value : (unsigned long long)value;
+    char buf[72];
+    std::to_chars_result r = std::to_chars(buf, buf+sizeof(buf), mag, base);
+    std::string digits(buf, (size_t)(r.ptr-buf));
+    if(type == 'X')
+        for(size_t i=0; i<digits.size(); i++)
+            digits[i] = (char)toupper(digits[i]);
+    if(spec.grouping)
+        __fmt_group(digits, 0, digits.size(), spec.grouping, base == 10 ? 3 : 4);
+
+    std::string sign = __fmt_sign(value < 0, spec);
+    if(spec.alt)
+        sign += prefix;
+    __fmt_align(result, sign, digits.data(), digits.size(), digits.size(), spec, '>');
+}
+
+static thread_local std::unordered_map<std::string, std::shared_ptr<std::vector<__fmt_item>>> __fmt_cache;
+
+std::shared_ptr<std::vector<__fmt_item>> __fmt_parse(str *fmt) { /* parse once per format string */
+    std::string key(fmt->unit.data(), fmt->unit.size());
+    auto it = __fmt_cache.find(key);
+    if(it != __fmt_cache.end())
+        return it->second;
+
+    auto items = std::make_shared<std::vector<__fmt_item>>();
+    const char *s = key.data();
+    size_t n = key.size(), i = 0;
+    int auto_index = 0;
+    bool manual = false;
+    __fmt_item item;
+
+    while(i < n) {
+        char c = s[i++];
+        if(c == '}') {
+            if(i < n && s[i] == '}') {
+                item.text += '}';
+                i++;
+                continue;
+            }
+            throw new ValueError(new str("Single '}' encountered in format string"));
+        }
+        if(c != '{') {
+            item.text += c;
+            continue;
+        }
+        if(i < n && s[i] == '{') {
+            item.text += '{';
+            i++;
+            continue;
+        }
+
+        /* replacement field */
+        size_t end = i;
+        while(end < n && s[end] != '}' && s[end] != '{')
+            end++;
+        if(end == n)
+            throw new ValueError(new str("expected '}' before end of string"));
+        if(s[end] == '{')
+            throw new ValueError(new str("nested format fields are not supported"));
+
+        size_t j = i;
+        __ss_int index;
+        if(__fmt_digits(s, end, j, index)) {
+            if(!manual && auto_index)
+                throw new ValueError(new str("cannot switch from automatic field numbering to manual field specification"));
+            manual = true;
+            item.index = index;
+        } else {
+            if(manual)
+                throw new ValueError(new str("cannot switch from manual field specification to automatic field numbering"));
+            item.index = auto_index++;
+        }
+        item.conv = 0;
+        if(j < end && s[j] == '!') {
+            if(j+1 >= end)
+                throw new ValueError(new str("end of string while looking for conversion specifier"));
+            item.conv = s[j+1];
+            if(item.conv != 'r' && item.conv != 's' && item.conv != 'a')
+                throw new ValueError(new str("Unknown conversion specifier"));
+            j += 2;
+        }
+        if(j < end && s[j] == ':') {
+            item.spec = __fmt_parse_spec(s+j+1, end-j-1);
+            j = end;
+        } else
+            item.spec = __fmt_spec();
+        if(j != end)
+            throw new ValueError(new str("only positional format fields are supported"));
+
+        items->push_back(item);
+        item = __fmt_item();
+        i = end+1;
+    }
+    if(!item.text.empty())
+        items->push_back(item);
+
+    if(__fmt_cache.size() >= 1024) /* bound the cache; callers keep their own reference */
+        __fmt_cache.clear();
+    __fmt_cache[key] = items;
+    return items;
+}
@@ -296,3 +296,133 @@ template<class T> bytes *__modtuple(bytes *bfmt, tuple2<T,T> *t) {
 template<class A, class B> bytes *__modtuple(bytes *fmt, tuple2<A,B> *t) {
     return __mod6(fmt, 2, t->__getfirst__(), t->__getsecond__());
 }
+
+/* str.format, f-string format specs */
+
+class __fmt_spec {
+public:
+    char fill[5];
+    char align, sign;
+    bool alt, zero;
+    char grouping;
+    __ss_int width, precision;
+    char type;
+
+    __fmt_spec();
+    __fmt_spec(const char *fill, char align, char sign, bool alt, bool zero, __ss_int width, char grouping, __ss_int precision, char type);
+
+    inline bool __empty() const { return !align && !sign && !alt && !zero && !grouping && width == -1 && precision == -1 && !type; }
+};
+
+class __fmt_item { /* literal text, followed by replacement field 'index' (if not -1) */
+public:
+    std::string text;
+    __ss_int index;
+    char conv;
+    __fmt_spec spec;
+
+    __fmt_item() : index(-1), conv(0) {}
+};
+
+__fmt_spec __fmt_parse_spec(const char *s, size_t n);
+__fmt_spec __fmt_parse_spec(str *s);
+std::shared_ptr<std::vector<__fmt_item>> __fmt_parse(str *fmt);
+
+void __fmt_str(str *result, str *s, const __fmt_spec &spec);
+void __fmt_int(str *result, __ss_int value, const __fmt_spec &spec);
+void __fmt_float(str *result, __ss_float value, const __fmt_spec &spec);
+
+template<class T> inline void __fmt_value(str *result, T value, const __fmt_spec &spec) {
+    if(spec.__empty())
+        result->unit += __str(value)->unit;
+    else
+        __fmt_str(result, __str(value), spec);
+}
+template<> inline void __fmt_value(str *result, str *value, const __fmt_spec &spec) {
+    if(spec.__empty())
+        result->unit += value->unit;
+    else
+        __fmt_str(result, value, spec);
+}
+template<> inline void __fmt_value(str *result, __ss_int value, const __fmt_spec &spec) {
+    if(spec.__empty())
+        result->unit += __str(value)->unit;
+    else
+        __fmt_int(result, value, spec);
+}
+template<> inline void __fmt_value(str *result, __ss_bool value, const __fmt_spec &spec) {
+    if(spec.__empty())
+        result->unit += __str(value)->unit;
+    else
+        __fmt_int(result, value.value, spec);
+}
+template<> inline void __fmt_value(str *result, __ss_float value, const __fmt_spec &spec) {
+    if(spec.__empty())
+        result->unit += __str(value)->unit;
+    else
+        __fmt_float(result, value, spec);
+}
+
+/* format strings known at compile-time: literal text and fields with pre-parsed specs */
+
+class __fmt_text {
+public:
+    const char *text;
+    size_t size;
+
+    __fmt_text(const char *text, size_t size) : text(text), size(size) {}
+};
+
+template<class T> class __fmt_field {
+public:
+    T value;
+    __fmt_spec spec;
+
+    __fmt_field(T value, __fmt_spec spec) : value(value), spec(spec) {}
+};
+
+template<class T> inline __fmt_field<T> __fmtf(T value, __fmt_spec spec=__fmt_spec()) {
+    return __fmt_field<T>(value, spec);
+}
+
+inline void __fmt_put(str *result, __fmt_text t) {
+    result->unit.append(t.text, t.size);
+}
+template<class T> inline void __fmt_put(str *result, __fmt_field<T> f) {
+    __fmt_value(result, f.value, f.spec);
+}
+
+template<class ... Args> str *__fmt_write(Args ... pieces) {
+    str *result = new str();
+    (__fmt_put(result, pieces), ...);
+    return result;
+}
+
+/* other format strings: parsed once, then cached */
+
+template<class T> void __fmt_arg(str *result, T arg, __fmt_item &item) {
+    if(item.conv == 'r')
+        __fmt_value(result, repr(arg), item.spec);
+    else if(item.conv == 'a')
+        __fmt_value(result, __ascii(repr(arg)), item.spec);
+    else if(item.conv == 's')
+        __fmt_value(result, __str(arg), item.spec);
+    else
+        __fmt_value(result, arg, item.spec);
+}
+
+template<class ... Args> str *__str_format(str *fmt, Args ... args) {
+    std::shared_ptr<std::vector<__fmt_item>> items = __fmt_parse(fmt);
+    str *result = new str();
+    for(size_t i=0; i<items->size(); i++) {
+        __fmt_item &item = (*items)[i];
+        result->unit.append(item.text.data(), item.text.size());
+        if(item.index != -1) {
+            if((size_t)item.index >= sizeof...(args))
+                throw new IndexError(__mod6(new str("Replacement index %d out of range for positional args tuple"), 1, item.index));
+            size_t k = 0;
+            ((k++ == (size_t)item.index ? __fmt_arg(result, args, item) : void()), ...);
+        }
+    }
+    return result;
+}
@@ -17,24 +17,32 @@ str *input(str *msg) {
 
 /* int */
 
-__ss_int __int(str *s, __ss_int base) {
+bool __int_parse(str *s, __ss_int &i, __ss_int base) { /* non-throwing, for try/except ValueError */
     char *cp;
-    __ss_int i;
+    __ss_int j;
 #ifdef __SS_LONG
-    i = (__ss_int)strtoll(s->c_str(), &cp, base);
+    j = (__ss_int)strtoll(s->c_str(), &cp, base);
 #else
-    i = (__ss_int)strtol(s->c_str(), &cp, base);
+    j = (__ss_int)strtol(s->c_str(), &cp, base);
 #endif
     if(*cp != '\0') {
         s = s->rstrip();
         #ifdef __SS_LONG
-            i = (__ss_int)strtoll(s->c_str(), &cp, base);
+            j = (__ss_int)strtoll(s->c_str(), &cp, base);
         #else
-            i = (__ss_int)strtol(s->c_str(), &cp, base);
+            j = (__ss_int)strtol(s->c_str(), &cp, base);
         #endif
         if(*cp != '\0')
-            throw new ValueError(new str("invalid literal for int()"));
+            return false;
     }
+    i = j;
+    return true;
+}
+
+__ss_int __int(str *s, __ss_int base) {
+    __ss_int i;
+    if(!__int_parse(s, i, base))
+        throw new ValueError(new str("invalid literal for int()"));
     return i;
 }
 
@@ -68,6 +76,28 @@ template<> __ss_float __float(str *s) {
     return d;
 }
 
+/* chr */
+
+str *__chr_utf8(__ss_int i) {
+    char buf[4];
+    size_t n;
+    if(i < 0x800) {
+        buf[0] = (char)(0xc0 | (i >> 6));
+        n = 2;
+    } else if(i < 0x10000) {
+        buf[0] = (char)(0xe0 | (i >> 12));
+        buf[1] = (char)(0x80 | ((i >> 6) & 0x3f));
+        n = 3;
+    } else {
+        buf[0] = (char)(0xf0 | (i >> 18));
+        buf[1] = (char)(0x80 | ((i >> 12) & 0x3f));
+        buf[2] = (char)(0x80 | ((i >> 6) & 0x3f));
+        n = 4;
+    }
+    buf[n-1] = (char)(0x80 | (i & 0x3f));
+    return new str(buf, n);
+}
+
 /* id */
 
 template<> __ss_int id(__ss_int) { throw new TypeError(new str("'id' called with integer")); }
@@ -76,24 +106,14 @@ template<> __ss_int id(__ss_bool) { throw new TypeError(new str("'id' called wit
 
 /* range */
 
-static int range_len(int lo, int hi, int step) {
+__ss_int __range_len(__ss_int lo, __ss_int hi, __ss_int step) {
     /* modified from CPython */
-    int n = 0;
-    if ((lo < hi) && (step>0)) {
-        unsigned int uhi = (unsigned int)hi;
-        unsigned int ulo = (unsigned int)lo;
-        unsigned int diff = uhi - ulo - 1;
-        n = (int)(diff / (unsigned int)step + 1);
-    }
-    else {
-        if ((lo > hi) && (step<0)) {
-            unsigned int uhi = (unsigned int)lo;
-            unsigned int ulo = (unsigned int)hi;
-            unsigned int diff = uhi - ulo - 1;
-            n = (int)(diff / (unsigned int)(-step) + 1);
-        }
-    }
-    return n;
+    typedef std::make_unsigned<__ss_int>::type __ss_uint;
+    if ((lo < hi) && (step>0))
+        return (__ss_int)(((__ss_uint)hi - (__ss_uint)lo - 1) / (__ss_uint)step + 1);
+    if ((lo > hi) && (step<0))
+        return (__ss_int)(((__ss_uint)lo - (__ss_uint)hi - 1) / (0 - (__ss_uint)step) + 1);
+    return 0;
 }
 
 class __rangeiter : public __iter<__ss_int> {
@@ -121,7 +141,7 @@ public:
                 return i-s;
         }
 
-        throw new StopIteration();
+        __throw_stop_iteration();
     }
 
 };
@@ -156,7 +176,7 @@ __iter<__ss_int> *__xrange::__iter__() {
 }
 
 __ss_int __xrange::__len__() {
-    return range_len(a, b, s);
+    return __range_len(a, b, s);
 }
 
 __ss_int __xrange::__getitem__(__ss_int i) {
@@ -188,7 +208,7 @@ __xrange *range(__ss_int a, __ss_int b, __ss_int s) { return new __xrange(a,b,s)
 __xrange *range(__ss_int n) { return new __xrange(0, n, 1); }
 
 __iter<__ss_int> *reversed(__xrange *x) {
-   return new __rangeiter(x->a+(range_len(x->a,x->b,x->s)-1)*x->s, x->a-x->s, -x->s);
+   return new __rangeiter(x->a+(__range_len(x->a,x->b,x->s)-1)*x->s, x->a-x->s, -x->s);
 }
 
 /* repr */
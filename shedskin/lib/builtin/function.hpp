@@ -91,6 +91,16 @@ template<class A, class B> typename A::for_in_unit ___max(int, pycall1<B, typena
     return max;
 }
 template<class A> typename A::for_in_unit ___max(int nn, int, A *iter) { return ___max(nn, (int (*)(typename A::for_in_unit))0, iter); }
+template<class K, class V> tuple2<K, V> *___max(int, int, __dictiteritems<K, V> *iter) { /* compare entries in place, allocate only the result */
+    typename __GC_DICT<K, V>::iterator it = iter->it, end = iter->p->gcd.end(), max = it;
+    if(it == end)
+        throw new ValueError(new str("max() arg is an empty sequence"));
+    for(; it != end; it++)
+        if(__cmp_pair(*it, *max) == 1)
+            max = it;
+    iter->it = end;
+    return new tuple2<K, V>(2, (*max).first, (*max).second);
+}
 
 template<class T, class B> inline T ___max(int, B (*key)(T), T a, T b) { return (__cmp(key(a), key(b))==1)?a:b; }
 template<class T> inline  T ___max(int, int, T a, T b) { return (__cmp(a, b)==1)?a:b; }
@@ -151,6 +161,16 @@ template<class A, class B> typename A::for_in_unit ___min(int, B (*key)(typename
     return min;
 }
 template<class A> typename A::for_in_unit ___min(int nn, int, A *iter) { return ___min(nn, (int (*)(typename A::for_in_unit))0, iter); }
+template<class K, class V> tuple2<K, V> *___min(int, int, __dictiteritems<K, V> *iter) {
+    typename __GC_DICT<K, V>::iterator it = iter->it, end = iter->p->gcd.end(), min = it;
+    if(it == end)
+        throw new ValueError(new str("min() arg is an empty sequence"));
+    for(; it != end; it++)
+        if(__cmp_pair(*it, *min) == -1)
+            min = it;
+    iter->it = end;
+    return new tuple2<K, V>(2, (*min).first, (*min).second);
+}
 
 template<class T, class B> inline T ___min(int, B (*key)(T), T a, T b) { return (__cmp(key(a), key(b))==-1)?a:b; }
 template<class T> inline  T ___min(int, int, T a, T b) { return (__cmp(a, b)==-1)?a:b; }
@@ -210,6 +230,12 @@ template <class A, class V, class W> list<A> *sorted(tuple2<A,A> *x, V cmp, W ke
     return l;
 }
 
+template <class K, class X, class V, class W> list<tuple2<K, X> *> *sorted(__dictiteritems<K, X> *x, V cmp, W key, __ss_int reverse) {
+    list<tuple2<K, X> *> *l = new list<tuple2<K, X> *>(x);
+    l->sort(cmp, key, reverse);
+    return l;
+}
+
 template <class V, class W> list<str *> *sorted(str *x, V cmp, W key, __ss_int reverse) {
     list<str *> *l = new list<str *>(x);
     l->sort(cmp, key, reverse);
@@ -304,7 +330,7 @@ template<class T, class U> inline izipiter<T, U>::izipiter(__ss_bool strict_, py
 
 template<class T, class U> tuple2<T, U> *izipiter<T, U>::__next__() {
     if (this->exhausted) {
-        throw new StopIteration();
+        __throw_stop_iteration();
     }
 
     tuple2<T, U> *tuple = new tuple2<T, U>;
@@ -327,7 +353,7 @@ template<class T, class U> tuple2<T, U> *izipiter<T, U>::__next__() {
         if (this->strict and n_exhausted != 2)
             throw new ValueError(new str("zip() arguments of different lengths"));
         else
-            throw new StopIteration();
+            __throw_stop_iteration();
     }
 
     return tuple;
@@ -373,7 +399,7 @@ template<class T> void izipiter<T, T>::push_iter(pyiter<T> *iterable) {
 
 template<class T> tuple2<T, T> *izipiter<T, T>::__next__() {
     if (this->exhausted) {
-        throw new StopIteration();
+        __throw_stop_iteration();
     }
 
     tuple2<T, T> *tuple = new tuple2<T, T>;
@@ -392,7 +418,7 @@ template<class T> tuple2<T, T> *izipiter<T, T>::__next__() {
         if (this->strict and n_exhausted != this->iters.size())
             throw new ValueError(new str("zip() arguments of different lengths"));
         else
-            throw new StopIteration();
+            __throw_stop_iteration();
     }
 
     return tuple;
@@ -457,7 +483,7 @@ template<class R, TP> inline imapiter##N<R, FP>::imapiter##N(R (*function_)(FP),
                                                                                                          \
 template<class R, TP> R imapiter##N<R, FP>::__next__() {                                                 \
     if (this->exhausted) {                                                                               \
-        throw new StopIteration();                                                                       \
+        __throw_stop_iteration();                                                                        \
     }                                                                                                    \
                                                                                                          \
     try  {                                                                                               \
@@ -572,14 +598,18 @@ template<class A> __ss_bool all(A *iter) {
 
 /* ord */
 
-static void __throw_ord_exc(size_t s) { /* improve inlining */
+[[noreturn]] static void __throw_ord_exc(size_t s) { /* improve inlining */
     throw new TypeError(__mod6(new str("ord() expected a character, but string of length %d found"), 1, s));
 }
 
 inline __ss_int ord(str *s) {
     size_t len = s->unit.size();
-    if(len != 1)
-        __throw_ord_exc(len);
+    if(len != 1) {
+        size_t cplen = (size_t)s->__len__();
+        if(cplen != 1)
+            __throw_ord_exc(cplen);
+        return __utf8_decode(s->c_str(), len);
+    }
     return (unsigned char)(s->c_str()[0]);
 }
 
@@ -610,19 +640,23 @@ inline str *bin(__ss_bool i) {
 
 /* chr */
 
-static void __throw_chr_out_of_range() { /* improve inlining */
-    throw new ValueError(new str("chr() arg not in range(256)"));
+[[noreturn]] static void __throw_chr_out_of_range() { /* improve inlining */
+    throw new ValueError(new str("chr() arg not in range(0x110000)"));
 }
 
+str *__chr_utf8(__ss_int i);
+
 template<class T> str *chr(T t) {
     return chr(t->__index__());
 }
 
 template<>
 inline str *chr(__ss_int i) {
-    if(i < 0 || i > 255)
+    if(i < 0 || i > 0x10ffff)
         __throw_chr_out_of_range();
-    return __char_cache[(size_t)i];
+    if(i < 128)
+        return __char_cache[(size_t)i];
+    return __chr_utf8(i);
 }
 
 template<>
@@ -22,10 +22,39 @@ template<> inline long hasher(__ss_float a) { return (long)std::hash<__ss_float>
 template<> inline long hasher(__ss_bool a) { return (long)std::hash<uint8_t>{}(a.value); }
 template<> inline long hasher(void *v) { return (long)std::hash<void *>{}(v); }
 
+/* tuples: xxHash-style mixing of the element hashes (as CPython does), inlined for the static element types */
+
+static inline uint64_t __tuple_hash_step(uint64_t acc, long lane) {
+    acc += (uint64_t)lane * 14029467366897019727ULL;
+    acc = (acc << 31) | (acc >> 33);
+    return acc * 11400714785074694791ULL;
+}
+
+static inline long __tuple_hash_end(uint64_t acc, size_t len) {
+    return (long)(acc + (len ^ (2870177450012600261ULL ^ 3527539ULL)));
+}
+
+template<class A, class B> inline long hasher(tuple2<A, B> *t) {
+    if(t == NULL) return 0;
+    uint64_t acc = 2870177450012600261ULL;
+    acc = __tuple_hash_step(acc, hasher(t->first));
+    acc = __tuple_hash_step(acc, hasher(t->second));
+    return __tuple_hash_end(acc, 2);
+}
+
+template<class T> inline long hasher(tuple2<T, T> *t) {
+    if(t == NULL) return 0;
+    uint64_t acc = 2870177450012600261ULL;
+    size_t sz = t->units.size();
+    for(size_t i = 0; i < sz; i++)
+        acc = __tuple_hash_step(acc, hasher(t->units[i]));
+    return __tuple_hash_end(acc, sz);
+}
+
 template<class T> class ss_hash {
     public:
         long operator()(const T t) const {
-            return hasher<T>(t);
+            return hasher(t);
         }
 
 };
@@ -21,6 +21,35 @@
         __ ## i ++; \
         e = __ ## temp->for_in_next(__ ## t);
 
+/* pointer iteration over immutable sequences, or when the loop body cannot resize the sequence */
+
+#define FOR_IN_SEQ(e, iter, temp, i, t) \
+    __ ## temp = iter; \
+    __ ## i = -1; \
+    (void)__ ## i; \
+    (void)__ ## t; \
+    for(auto __ ## t ## _p = (__ ## temp)->units.data(), __ ## t ## _end = __ ## t ## _p + (__ ## temp)->units.size(); __ ## t ## _p != __ ## t ## _end; __ ## t ## _p++) { \
+        __ ## i ++; \
+        e = *__ ## t ## _p;
+
+#define FOR_IN_STR(e, iter, temp, i, t) \
+    __ ## temp = iter; \
+    __ ## i = -1; \
+    (void)__ ## i; \
+    (void)__ ## t; \
+    for(const char *__ ## t ## _p = (__ ## temp)->unit.data(), *__ ## t ## _end = __ ## t ## _p + (__ ## temp)->unit.size(); __ ## t ## _p != __ ## t ## _end; ) { \
+        __ ## i ++; \
+        e = __str_next(__ ## t ## _p, __ ## t ## _end);
+
+#define FOR_IN_BYTES(e, iter, temp, i, t) \
+    __ ## temp = iter; \
+    __ ## i = -1; \
+    (void)__ ## i; \
+    (void)__ ## t; \
+    for(const char *__ ## t ## _p = (__ ## temp)->unit.data(), *__ ## t ## _end = __ ## t ## _p + (__ ## temp)->unit.size(); __ ## t ## _p != __ ## t ## _end; __ ## t ## _p++) { \
+        __ ## i ++; \
+        e = (unsigned char)(*__ ## t ## _p);
+
 #define FOR_IN_ZIP(a, b, k, l, t, u, n, m) \
     __ ## m = __SS_MIN(k->units.size(), l->units.size()); \
     __ ## t = k; \
@@ -36,7 +65,7 @@
 
 #define FOR_IN_ENUMERATE_STR(i, m, temp, n) \
     __ ## temp = m; \
-    for(__ ## n = 0; (unsigned int)__ ## n < (__ ## temp)->unit.size(); __ ## n ++) { \
+    for(__ ## n = 0; __ ## n < (__ ## temp)->__len__(); __ ## n ++) { \
         i = (__ ## temp)->__getfast__(__ ## n); \
 
 #define FOR_IN_DICT(m, temp, iter, pos) \
@@ -44,5 +73,16 @@
     __ ## iter = m->gcd.begin(); \
 	while (__ ## iter != m->gcd.end() ) { \
 
+#define FOR_IN_SPLIT(e, s, sep, maxsplit, temp, pos, n) \
+    __ ## temp = s; \
+    __ ## pos = 0; \
+    __ ## n = 0; \
+    while(__split_assign(e, (__ ## temp)->__split_next(sep, maxsplit, __ ## pos, __ ## n))) { \
+
+#define FOR_IN_SPLITLINES(e, s, keepends, temp, pos) \
+    __ ## temp = s; \
+    __ ## pos = 0; \
+    while(__split_assign(e, (__ ## temp)->__splitlines_next(keepends, __ ## pos))) { \
+
 #define END_FOR }
 
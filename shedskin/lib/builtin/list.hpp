@@ -34,18 +34,26 @@ template<class T> list<T>::list(tuple2<T, T> *p) {
 
 template<class T> list<T>::list(str *s) {
     this->__class__ = cl_list;
-    this->units.resize(s->unit.size());
-    size_t sz = s->unit.size();
+    size_t sz = (size_t)s->__len__();
+    this->units.resize(sz);
+    size_t pos = 0;
     for(size_t i=0; i<sz; i++)
-        this->units[i] = __char_cache[(unsigned char)s->unit[i]];
+        this->units[i] = s->for_in_next(pos);
 }
 
 #ifdef __SS_BIND
 template<class T> list<T>::list(PyObject *p) {
-    if(!PyList_Check(p))
+    this->__class__ = cl_list;
+    if(!PyList_Check(p)) {
+        if(list<T> *l = __ss_lazy_target<list<T> >(p)) {
+            this->units = l->units;
+            return;
+        }
+        if(__units_from_buffer(p, this->units))
+            return;
         throw new TypeError(new str("error in conversion to Shed Skin (list expected)"));
+    }
 
-    this->__class__ = cl_list;
     size_t size = (size_t)PyList_Size(p);
     this->units.resize(size);
     for(size_t i=0; i<size; i++)
@@ -59,6 +67,73 @@ template<class T> PyObject *list<T>::__to_py__() {
         PyList_SetItem(p, i, __to_py(this->__getitem__(i)));
     return p;
 }
+
+template<class T> class __ss_lazy_list_iter : public __ss_lazy_iter {
+public:
+    list<T> *target;
+    size_t i;
+
+    __ss_lazy_list_iter(list<T> *l) : target(l), i(0) {}
+    PyObject *__next() {
+        if(i >= target->units.size())
+            return NULL;
+        return __to_py_lazy(target->units[i++]);
+    }
+};
+
+template<class T> class __ss_lazy_list : public __ss_lazy_of<list<T> > {
+public:
+    __ss_lazy_list(list<T> *l) : __ss_lazy_of<list<T> >(l) {}
+
+    Py_ssize_t __len() { return (Py_ssize_t)this->target->units.size(); }
+
+    PyObject *__item(PyObject *key) {
+        Py_ssize_t n = __len();
+        if(PySlice_Check(key)) {
+            Py_ssize_t start, stop, step;
+            if(PySlice_Unpack(key, &start, &stop, &step) < 0)
+                return NULL;
+            Py_ssize_t len = PySlice_AdjustIndices(n, &start, &stop, step);
+            PyObject *p = PyList_New(len);
+            for(Py_ssize_t i=0; i<len; i++)
+                PyList_SET_ITEM(p, i, __to_py_lazy(this->target->units[(size_t)(start+i*step)]));
+            return p;
+        }
+        Py_ssize_t i = PyNumber_AsSsize_t(key, PyExc_IndexError);
+        if(i == -1 && PyErr_Occurred())
+            return NULL;
+        if(i < 0)
+            i += n;
+        if(i < 0 || i >= n) {
+            PyErr_SetString(PyExc_IndexError, "list index out of range");
+            return NULL;
+        }
+        return __to_py_lazy(this->target->units[(size_t)i]);
+    }
+
+    int __contains(PyObject *key) {
+        for(size_t i=0; i<this->target->units.size(); i++) {
+            PyObject *p = __to_py_lazy(this->target->units[i]);
+            if(!p)
+                return -1;
+            int r = PyObject_RichCompareBool(p, key, Py_EQ);
+            Py_DECREF(p);
+            if(r)
+                return r;
+        }
+        return 0;
+    }
+
+    __ss_lazy_iter *__iter() { return new __ss_lazy_list_iter<T>(this->target); }
+};
+
+template<class T> PyObject *__to_py_lazy(list<T> *l) {
+    if(!l) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    return __ss_lazy_new(&__ss_list_proxy_type, new __ss_lazy_list<T>(l));
+}
 #endif
 
 template<class T> void list<T>::clear() {
@@ -78,6 +153,16 @@ template<class T> T list<T>::__getitem__(__ss_int i) {
     return units[(size_t)i];
 }
 
+template<class T> template<class U> inline bool list<T>::__lookup__(__ss_int i, U &u) { /* non-throwing, for try/except IndexError */
+    __ss_int l = (__ss_int)units.size();
+    if(i < 0)
+        i += l;
+    if(i < 0 || i >= l)
+        return false;
+    u = units[(size_t)i];
+    return true;
+}
+
 template<class T> __ss_bool list<T>::__eq__(pyobj *p) {
    list<T> *b = (list<T> *)p;
    size_t len = this->units.size();
@@ -120,11 +205,12 @@ template<class T> void *list<T>::extend(tuple2<T,T> *p) {
 }
 
 template<class T> void *list<T>::extend(str *s) {
-    const size_t sz = s->unit.size();
+    const size_t sz = (size_t)s->__len__();
     const size_t org_size = this->units.size();
     this->units.resize(sz+org_size);
+    size_t pos = 0;
     for(size_t i=0; i<sz; i++)
-        this->units.at(i + org_size) = __char_cache[((unsigned char)(s->unit[i]))];
+        this->units.at(i + org_size) = s->for_in_next(pos);
     return NULL;
 }
 
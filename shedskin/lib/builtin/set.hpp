@@ -10,6 +10,11 @@ template <class T> set<T>::set(int frozen_) : frozen(frozen_) {
 template<class T> set<T>::set(PyObject *p) {
     this->__class__ = cl_set;
     this->hash = -1;
+    if(set<T> *s = __ss_lazy_target<set<T> >(p)) {
+        frozen = s->frozen;
+        gcs = s->gcs;
+        return;
+    }
     if(PyFrozenSet_CheckExact(p))
         frozen = 1;
     else if(PyAnySet_CheckExact(p))
@@ -37,6 +42,55 @@ template<class T> PyObject *set<T>::__to_py__() {
     return s;
 }
 
+template<class T> class __ss_lazy_set_iter : public __ss_lazy_iter {
+public:
+    set<T> *target;
+    __GC_VECTOR(T) elems; /* snapshot: compiled code may still change (and rehash) the set */
+    size_t i;
+
+    __ss_lazy_set_iter(set<T> *s) : target(s), elems(s->gcs.begin(), s->gcs.end()), i(0) {}
+    PyObject *__next() {
+        if(target->gcs.size() != elems.size()) {
+            PyErr_SetString(PyExc_RuntimeError, "set changed size during iteration");
+            return NULL;
+        }
+        if(i >= elems.size())
+            return NULL;
+        return __to_py_lazy(elems[i++]);
+    }
+};
+
+template<class T> class __ss_lazy_set : public __ss_lazy_of<set<T> > {
+public:
+    __ss_lazy_set(set<T> *s) : __ss_lazy_of<set<T> >(s) {}
+
+    Py_ssize_t __len() { return (Py_ssize_t)this->target->gcs.size(); }
+
+    PyObject *__item(PyObject *) {
+        PyErr_SetString(PyExc_TypeError, "'set' object is not subscriptable");
+        return NULL;
+    }
+
+    int __contains(PyObject *key) {
+        try {
+            return this->target->gcs.find(__to_ss<T>(key)) != this->target->gcs.end();
+        } catch (Exception *) {
+            PyErr_Clear();
+            return 0;
+        }
+    }
+
+    __ss_lazy_iter *__iter() { return new __ss_lazy_set_iter<T>(this->target); }
+};
+
+template<class T> PyObject *__to_py_lazy(set<T> *s) {
+    if(!s) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    return __ss_lazy_new(&__ss_set_proxy_type, new __ss_lazy_set<T>(s));
+}
+
 #endif
 
 template<class T> template<class U> set<T>::set(U *other, int frozen_) {
@@ -86,7 +140,7 @@ template <class T> void *set<T>::discard(T key) {
 template <class T> void *set<T>::remove(T key) {
     typename __GC_SET<T>::iterator it = gcs.find(key);
     if(it == gcs.end())
-        throw new KeyError(repr(key));
+        throw new __KeyError<T>(key);
     else
         gcs.erase(it);
     return NULL;
@@ -131,7 +185,7 @@ template<class T> long set<T>::__hash__() {
     hash_ *= __len__() + 1;
 
     for (const auto& key : gcs) {
-        long h = hasher<T>(key);
+        long h = hasher(key);
         hash_ ^= (h ^ (h << 16) ^ 89869747L)  * 3644798167u;
     }
     hash_ = hash_ * 69069L + 907133923L;
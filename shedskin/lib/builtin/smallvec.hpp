@@ -0,0 +1,202 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+/* small vector: the first few elements are stored inside the owning object, so that short
+   lists and tuples need a single allocation. it spills to a GC buffer when it grows beyond
+   that, and otherwise follows the std::vector interface used by the runtime (the allocator
+   parameter is kept so that code templated on vector<T, A> also accepts it) */
+
+template<class T, class A = gc_allocator<T> > class __ss_smallvec {
+public:
+    static const size_t N = sizeof(T) <= 8 ? 4 : 2;
+
+    typedef T value_type;
+    typedef A allocator_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+    typedef std::reverse_iterator<T *> reverse_iterator;
+    typedef std::reverse_iterator<const T *> const_reverse_iterator;
+
+private:
+    T *ptr;
+    size_t sz, cap;
+    T inl[N];
+
+    void grow(size_t n) {
+        if(n <= cap)
+            return;
+        size_t newcap = cap * 2;
+        if(newcap < n)
+            newcap = n;
+        T *buf = A().allocate(newcap);
+        for(size_t i = 0; i < sz; i++)
+            ::new((void *)(buf + i)) T(ptr[i]);
+        if(ptr != inl)
+            A().deallocate(ptr, cap);
+        ptr = buf;
+        cap = newcap;
+    }
+
+    void construct(size_t from, size_t to, const T &t) {
+        for(size_t i = from; i < to; i++)
+            ::new((void *)(ptr + i)) T(t);
+    }
+
+public:
+    __ss_smallvec() : ptr(inl), sz(0), cap(N) {}
+    __ss_smallvec(const __ss_smallvec &v) : ptr(inl), sz(0), cap(N) { assign(v.begin(), v.end()); }
+    __ss_smallvec(std::initializer_list<T> l) : ptr(inl), sz(0), cap(N) { assign(l.begin(), l.end()); }
+
+    __ss_smallvec &operator=(const __ss_smallvec &v) {
+        if(this != &v)
+            assign(v.begin(), v.end());
+        return *this;
+    }
+    __ss_smallvec &operator=(std::initializer_list<T> l) {
+        assign(l.begin(), l.end());
+        return *this;
+    }
+    template<class C> __ss_smallvec &operator=(const C &c) {
+        assign(c.begin(), c.end());
+        return *this;
+    }
+
+    size_t size() const { return sz; }
+    bool empty() const { return sz == 0; }
+    size_t capacity() const { return cap; }
+    size_t max_size() const { return A().max_size(); }
+    A get_allocator() const { return A(); }
+
+    T *data() { return ptr; }
+    const T *data() const { return ptr; }
+
+    T *begin() { return ptr; }
+    T *end() { return ptr + sz; }
+    const T *begin() const { return ptr; }
+    const T *end() const { return ptr + sz; }
+    const T *cbegin() const { return ptr; }
+    const T *cend() const { return ptr + sz; }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    T &operator[](size_t i) { return ptr[i]; }
+    const T &operator[](size_t i) const { return ptr[i]; }
+    T &at(size_t i) {
+        if(i >= sz)
+            throw std::out_of_range("__ss_smallvec::at");
+        return ptr[i];
+    }
+    const T &at(size_t i) const {
+        if(i >= sz)
+            throw std::out_of_range("__ss_smallvec::at");
+        return ptr[i];
+    }
+    T &front() { return ptr[0]; }
+    T &back() { return ptr[sz-1]; }
+    const T &front() const { return ptr[0]; }
+    const T &back() const { return ptr[sz-1]; }
+
+    void reserve(size_t n) { grow(n); }
+    void shrink_to_fit() {}
+
+    void clear() { sz = 0; }
+
+    void push_back(const T &t) {
+        if(sz == cap) {
+            T copy = t; /* t may point into the buffer */
+            grow(sz+1);
+            ::new((void *)(ptr + sz)) T(copy);
+        } else
+            ::new((void *)(ptr + sz)) T(t);
+        sz++;
+    }
+    void pop_back() { sz--; }
+
+    void resize(size_t n) { resize(n, T()); }
+    void resize(size_t n, const T &t) {
+        if(n > sz) {
+            T copy = t;
+            grow(n);
+            construct(sz, n, copy);
+        }
+        sz = n;
+    }
+
+    void assign(size_t n, const T &t) {
+        T copy = t;
+        sz = 0;
+        grow(n);
+        construct(0, n, copy);
+        sz = n;
+    }
+    template<class I, class = typename std::iterator_traits<I>::iterator_category> void assign(I first, I last) {
+        size_t n = (size_t)std::distance(first, last);
+        if(n > cap) { /* copy before releasing, the source may be our own buffer */
+            T *buf = A().allocate(n);
+            size_t i = 0;
+            for(; first != last; first++)
+                ::new((void *)(buf + i++)) T(*first);
+            if(ptr != inl)
+                A().deallocate(ptr, cap);
+            ptr = buf;
+            sz = cap = n;
+            return;
+        }
+        size_t i = 0;
+        for(; first != last; first++)
+            ptr[i++] = *first;
+        sz = n;
+    }
+
+    T *insert(const T *pos, const T &t) { return insert(pos, (size_t)1, t); }
+    T *insert(const T *pos, size_t n, const T &t) {
+        size_t i = (size_t)(pos - ptr);
+        T copy = t;
+        grow(sz+n);
+        std::copy_backward(ptr+i, ptr+sz, ptr+sz+n);
+        std::fill(ptr+i, ptr+i+n, copy);
+        sz += n;
+        return ptr+i;
+    }
+    template<class I, class = typename std::iterator_traits<I>::iterator_category> T *insert(const T *pos, I first, I last) {
+        size_t i = (size_t)(pos - ptr);
+        size_t n = (size_t)std::distance(first, last);
+        __ss_smallvec tmp; /* the source may be our own buffer */
+        tmp.assign(first, last);
+        grow(sz+n);
+        std::copy_backward(ptr+i, ptr+sz, ptr+sz+n);
+        std::copy(tmp.begin(), tmp.end(), ptr+i);
+        sz += n;
+        return ptr+i;
+    }
+
+    T *erase(const T *pos) { return erase(pos, pos+1); }
+    T *erase(const T *first, const T *last) {
+        T *f = ptr + (first - ptr), *l = ptr + (last - ptr);
+        std::copy(l, ptr+sz, f);
+        sz -= (size_t)(l - f);
+        return f;
+    }
+
+    void swap(__ss_smallvec &v) {
+        if(ptr != inl && v.ptr != v.inl) {
+            std::swap(ptr, v.ptr);
+            std::swap(sz, v.sz);
+            std::swap(cap, v.cap);
+            return;
+        }
+        __ss_smallvec tmp(v);
+        v = *this;
+        *this = tmp;
+    }
+
+    bool operator==(const __ss_smallvec &v) const { return sz == v.sz && std::equal(begin(), end(), v.begin()); }
+    bool operator!=(const __ss_smallvec &v) const { return !(*this == v); }
+};
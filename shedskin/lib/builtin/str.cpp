@@ -4,22 +4,36 @@
 
 /* str methods */
 
-str::str() : hash(-1), charcache(0) {
+str::str() : hash(-1), charcache(0), ascii(-1), cpindex(0) {
     __class__ = cl_str_;
 }
 
-str::str(const char *s) : unit(s), hash(-1), charcache(0) {
+str::str(const char *s) : unit(s), hash(-1), charcache(0), ascii(-1), cpindex(0) {
     __class__ = cl_str_;
 }
 
-str::str(__GC_STRING s) : unit(s), hash(-1), charcache(0) {
+str::str(__GC_STRING s) : unit(s), hash(-1), charcache(0), ascii(-1), cpindex(0) {
     __class__ = cl_str_;
 }
 
-str::str(const char *s, size_t size) : unit(s, size), hash(-1), charcache(0) { /* '\0' delimiter in C */
+str::str(const char *s, size_t size) : unit(s, size), hash(-1), charcache(0), ascii(-1), cpindex(0) { /* '\0' delimiter in C */
     __class__ = cl_str_;
 }
 
+/* the atomics are not copyable; the code point index only depends on 'unit', so it can be shared */
+str::str(const str &s) : pyseq<str *>(s), unit(s.unit), hash(s.hash), charcache(s.charcache), ascii(s.ascii.load(std::memory_order_relaxed)), cpindex(s.cpindex.load(std::memory_order_acquire)) {
+}
+
+str &str::operator=(const str &s) {
+    pyseq<str *>::operator=(s);
+    unit = s.unit;
+    hash = s.hash;
+    charcache = s.charcache;
+    ascii.store(s.ascii.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    cpindex.store(s.cpindex.load(std::memory_order_acquire), std::memory_order_release);
+    return *this;
+}
+
 str *str::__str__() {
     return this;
 }
@@ -44,13 +58,18 @@ str *str::__repr__() {
         quote = "\"";
 
     ss << quote;
-    for(unsigned int i=0; i<this->unit.size(); i++)
+    size_t w, size = this->unit.size();
+    for(size_t i=0; i<size; i++)
     {
         char c = unit[i];
         size_t k;
 
         if((k = separator.find_first_of(c)) != std::string::npos)
             ss << "\\" << let[k];
+        else if((unsigned char)c >= 0xc0 and (w = __utf8_width(unit.data(), size, i)) > 1) {
+            ss.write(unit.data()+i, (std::streamsize)w);
+            i += w-1;
+        }
         else {
             int j = (int)((unsigned char)c);
 
@@ -67,6 +86,31 @@ str *str::__repr__() {
     return new str(ss.str().c_str());
 }
 
+str *__ascii(str *r) {
+    if(r->__is_ascii())
+        return r;
+    str *result = new str();
+    const char *data = r->unit.data();
+    size_t w, size = r->unit.size();
+    char buf[16];
+    for(size_t i=0; i<size; i += w) {
+        w = __utf8_width(data, size, i);
+        __ss_int c = __utf8_decode(data+i, w);
+        if(c < 0x80)
+            result->unit += (char)c;
+        else {
+            if(c < 0x100)
+                snprintf(buf, sizeof(buf), "\\x%02x", (unsigned int)c);
+            else if(c < 0x10000)
+                snprintf(buf, sizeof(buf), "\\u%04x", (unsigned int)c);
+            else
+                snprintf(buf, sizeof(buf), "\\U%08x", (unsigned int)c);
+            result->unit += buf;
+        }
+    }
+    return result;
+}
+
 __ss_int str::__int__() {
     return __int(this);
 }
@@ -89,10 +133,14 @@ str *str::operator+ (const char &rhs) {
 
 void str::operator+= (const char *rhs) {
     this->unit += rhs;
+    ascii = -1;
+    cpindex = 0;
 }
 
 void str::operator+= (const char &rhs) {
     this->unit += rhs;
+    ascii = -1;
+    cpindex = 0;
 }
 
 __ss_bool str::__ctype_function(int (*cfunc)(int))
@@ -118,27 +166,20 @@ __ss_bool str::isupper() { return __ctype_function(&::isupper); }
 __ss_bool str::isprintable() {
   size_t i, l = this->unit.size();
 
-  for(i = 0; i < l; i++) {
-      unsigned char elem = (unsigned char)unit[i];
+  for(i = 0; i < l; ) {
+      size_t w = __utf8_width(unit.data(), l, i);
+      __ss_int elem = __utf8_decode(unit.data()+i, w);
 
       if(elem <= 31 or (127 <= elem and elem <= 160) or elem == 173)
           return False;
+      i += w;
   }
 
   return True;
 }
 
 __ss_bool str::__ss_isascii() {
-  size_t i, l = this->unit.size();
-
-  for(i = 0; i < l; i++) {
-      unsigned char elem = (unsigned char)unit[i];
-
-      if(elem > 127)
-          return False;
-  }
-
-  return True;
+    return __mbool(__is_ascii());
 }
 
 __ss_bool str::isdecimal() {
@@ -367,6 +408,26 @@ list<str *> *str::splitlines(__ss_int keepends)
     return r;
 }
 
+str *str::__splitlines_next(__ss_int keepends, size_t &pos) { /* lazy splitlines, NULL when done */
+    if(pos == std::string::npos)
+        return NULL;
+
+    size_t j = pos, endlen;
+    size_t i = unit.find_first_of("\r\n", j);
+    if(i == std::string::npos) {
+        pos = std::string::npos;
+        if(j != unit.size())
+            return new str(unit.substr(j));
+        return NULL;
+    }
+
+    if(unit[i] == '\r' && unit[i + 1] == '\n') endlen = 2;
+    else endlen = 1;
+
+    pos = i + endlen;
+    return new str(unit.substr(j, i - j + (keepends ? endlen : 0)));
+}
+
 str *str::rstrip(str *chars) {
     __GC_STRING remove;
     if(chars) remove = chars->unit;
@@ -417,6 +478,34 @@ list<str *> *str::split(str *sep_, __ss_int maxsplit) {
     return result;
 }
 
+str *str::__split_next(str *sep_, __ss_int maxsplit, size_t &pos, __ss_int &splits) { /* lazy split, NULL when done */
+    size_t pos_end;
+
+    if(pos == std::string::npos)
+        return NULL;
+
+    if(sep_ == NULL) {
+        pos = unit.find_first_not_of(ws, pos);
+        if(pos == std::string::npos)
+            return NULL;
+        pos_end = unit.find_first_of(ws, pos);
+    } else {
+        if(sep_->unit.empty())
+            throw new ValueError(new str("empty separator"));
+        pos_end = unit.find(sep_->unit, pos);
+    }
+
+    size_t pos_start = pos;
+    if(pos_end == std::string::npos || ((maxsplit != -1) && splits >= maxsplit)) {
+        pos = std::string::npos;
+        return new str(unit.substr(pos_start));
+    }
+
+    splits += 1;
+    pos = pos_end + (sep_ ? sep_->unit.size() : 0);
+    return new str(unit.substr(pos_start, pos_end-pos_start));
+}
+
 str *str::translate(str *table, str *delchars) {
     if(len(table) != 256)
         throw new ValueError(new str("translation table must be 256 characters long"));
@@ -442,12 +531,20 @@ str *str::swapcase() {
 }
 
 str *str::center(__ss_int w, str *fillchar) {
+    if(!fillchar) fillchar = sp;
+    if(!__is_ascii() or !fillchar->__is_ascii()) {
+        __ss_int cplen = __len__();
+        if(w<=cplen)
+            return this;
+        __ss_int left = (w-cplen)/2;
+        return __add_strs(3, fillchar->__mul__(left), this, fillchar->__mul__(w-cplen-left));
+    }
+
     size_t width = (size_t)w;
     size_t len = unit.size();
     if(width<=len)
         return this;
 
-    if(!fillchar) fillchar = sp;
     str *r = fillchar->__mul__(w);
 
     size_t j = (width-len)/2;
@@ -511,6 +608,8 @@ str *str::__add__(str *b) {
     s->unit.reserve(this->unit.size()+b->unit.size());
     s->unit.append(unit);
     s->unit.append(b->unit);
+    if(ascii == 1 and b->ascii == 1)
+        s->ascii = 1;
 
     return s;
 }
@@ -519,58 +618,115 @@ str *str::__iadd__(str *b) {
 }
 
 str *str::__slice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s) {
+    if(!__is_ascii())
+        return __slice_cp(x, l, u, s);
     size_t len = this->unit.size();
     slicenr(x, l, u, s, (__ss_int)len);
+    str *r;
     if(s == 1)
-        return new str(unit.data()+l, (size_t)(u-l));
+        r = new str(unit.data()+l, (size_t)(u-l));
     else {
-        __GC_STRING r;
+        r = new str();
         if(!(x&1) && !(x&2) && s==-1) {
-            r.resize(len);
+            r->unit.resize(len);
             for(size_t i=0; i<len; i++)
-                r[i] = unit[len-i-1];
+                r->unit[i] = unit[len-i-1];
         }
         else if(s > 0)
             for(__ss_int i=l; i<u; i += s)
-                r += unit[(size_t)i];
+                r->unit += unit[(size_t)i];
         else
             for(__ss_int i=l; i>u; i += s)
-                r += unit[(size_t)i];
-        return new str(r);
+                r->unit += unit[(size_t)i];
     }
+    r->ascii = 1;
+    return r;
 }
 
-__ss_int str::__fixstart(size_t a, __ss_int b) {
-    if(a == std::string::npos) return -1;
-    return (__ss_int)a+b;
+str *str::__slice_cp(__ss_int x, __ss_int l, __ss_int u, __ss_int s) {
+    slicenr(x, l, u, s, __len__());
+    str *r = new str();
+    if(s == 1) {
+        if(u > l) {
+            size_t a = __byte_offset(l);
+            r->unit.assign(unit.data()+a, __byte_offset(u)-a);
+        }
+    }
+    else if(s > 0)
+        for(__ss_int i=l; i<u; i += s)
+            r->unit.append(__cp_at(__byte_offset(i))->unit);
+    else
+        for(__ss_int i=l; i>u; i += s)
+            r->unit.append(__cp_at(__byte_offset(i))->unit);
+    return r;
 }
 
-__ss_int str::find(str *s, __ss_int a) {
-    __ss_int step = 1;
-    __ss_int b = this->__len__();
-    slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, this->unit.size()-(size_t)a).find(s->unit), a);
+__str_index *str::__build_index() { /* filled in before it is published */
+    const char *data = unit.data();
+    size_t size = unit.size();
+    size_t pos = 0;
+    __ss_int n = 0;
+    __str_index *index = new __str_index();
+    index->offsets.reserve(size/STR_INDEX_STRIDE+1);
+    while(pos < size) {
+        if((size_t)n % STR_INDEX_STRIDE == 0)
+            index->offsets.push_back(pos);
+        pos += __utf8_width(data, size, pos);
+        n++;
+    }
+    index->length = n;
+    cpindex.store(index, std::memory_order_release);
+    return index;
+}
+
+size_t str::__byte_offset(__ss_int i) { /* code point index -> byte offset */
+    if(__is_ascii())
+        return (size_t)i;
+    __str_index *index = __index();
+    if(i >= index->length)
+        return unit.size();
+    size_t pos = index->offsets[(size_t)i / STR_INDEX_STRIDE];
+    for(size_t k = (size_t)i % STR_INDEX_STRIDE; k > 0; k--)
+        pos += __utf8_width(unit.data(), unit.size(), pos);
+    return pos;
+}
+
+__ss_int str::__cp_offset(size_t pos) { /* byte offset -> code point index */
+    if(__is_ascii())
+        return (__ss_int)pos;
+    __str_index *index = __index();
+    size_t k = (size_t)(std::upper_bound(index->offsets.begin(), index->offsets.end(), pos) - index->offsets.begin()) - 1;
+    size_t p = index->offsets[k];
+    __ss_int n = (__ss_int)(k * STR_INDEX_STRIDE);
+    for(; p < pos; n++)
+        p += __utf8_width(unit.data(), unit.size(), p);
+    return n;
 }
 
-__ss_int str::find(str *s, __ss_int a, __ss_int b) {
-    __ss_int step = 1;
-    slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, (size_t)(b-a)).find(s->unit), a);
-
+__ss_int str::__fixstart(size_t a, __ss_int b) {
+    if(a == std::string::npos) return -1;
+    return (__ss_int)a+b;
 }
 
-__ss_int str::rfind(str *s, __ss_int a) {
+__ss_int str::__find(str *s, __ss_int a, __ss_int b, bool reverse) {
     __ss_int step = 1;
-    __ss_int b = this->__len__();
     slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, this->unit.size()-(size_t)a).rfind(s->unit), a);
+    if(b < a)
+        return -1;
+    size_t start = __byte_offset(a);
+    std::string_view view(unit.data()+start, __byte_offset(b)-start);
+    std::string_view needle(s->unit.data(), s->unit.size());
+    size_t pos = reverse ? view.rfind(needle) : view.find(needle);
+    if(pos == std::string::npos)
+        return -1;
+    return __cp_offset(start+pos);
 }
 
-__ss_int str::rfind(str *s, __ss_int a, __ss_int b) {
-    __ss_int step = 1;
-    slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, (size_t)(b-a)).rfind(s->unit), a);
-}
+__ss_int str::find(str *s, __ss_int a) { return __find(s, a, __len__(), false); }
+__ss_int str::find(str *s, __ss_int a, __ss_int b) { return __find(s, a, b, false); }
+
+__ss_int str::rfind(str *s, __ss_int a) { return __find(s, a, __len__(), true); }
+__ss_int str::rfind(str *s, __ss_int a, __ss_int b) { return __find(s, a, b, true); }
 
 __ss_int str::__checkneg(__ss_int i) {
     if(i == -1)
@@ -589,10 +745,11 @@ __ss_int str::count(str *s, __ss_int start, __ss_int end) {
     __ss_int count, one = 1;
     size_t i;
     slicenr(7, start, end, one, __len__());
+    size_t bend = __byte_offset(end);
 
-    i = (size_t)start;
+    i = __byte_offset(start);
     count = 0;
-    while( ((i = this->unit.find(s->c_str(), i)) != std::string::npos) && (i <= (size_t)end-s->unit.size()) )
+    while( ((i = this->unit.find(s->c_str(), i)) != std::string::npos) && (i <= bend-s->unit.size()) )
     {
         i += s->unit.size();
         count++;
@@ -606,8 +763,8 @@ __ss_bool str::startswith(str *s, __ss_int start, __ss_int end) {
     __ss_int one = 1;
     slicenr(7, start, end, one, __len__());
 
-    size_t i, j;
-    for(i = (size_t)start, j = 0; i < (size_t)end && j < s->unit.size(); )
+    size_t i, j, bend = __byte_offset(end);
+    for(i = __byte_offset(start), j = 0; i < bend && j < s->unit.size(); )
         if (unit[i++] != s->unit[j++])
             return False;
 
@@ -619,8 +776,8 @@ __ss_bool str::endswith(str *s, __ss_int start, __ss_int end) {
     __ss_int one = 1;
     slicenr(7, start, end, one, __len__());
 
-    size_t i, j;
-    for(i = (size_t)end, j = s->unit.size(); i > (size_t)start && j > 0; )
+    size_t i, j, bstart = __byte_offset(start);
+    for(i = __byte_offset(end), j = s->unit.size(); i > bstart && j > 0; )
         if (unit[--i] != s->unit[--j])
             return False;
 
@@ -645,7 +802,7 @@ str *str::upper() {
     if(this->unit.size() == 1)
         return __char_cache[((unsigned char)(::toupper(unit[0])))];
 
-    str *toReturn = new str(*this);
+    str *toReturn = new str(this->unit);
     std::transform(toReturn->unit.begin(), toReturn->unit.end(), toReturn->unit.begin(), toupper);
 
     return toReturn;
@@ -655,7 +812,7 @@ str *str::lower() {
     if(this->unit.size() == 1)
         return __char_cache[((unsigned char)(::tolower(unit[0])))];
 
-    str *toReturn = new str(*this);
+    str *toReturn = new str(this->unit);
     std::transform(toReturn->unit.begin(), toReturn->unit.end(), toReturn->unit.begin(), tolower);
 
     return toReturn;
@@ -707,7 +864,7 @@ str *str::capitalize() {
 }
 
 #ifdef __SS_BIND
-str::str(PyObject *p) : hash(-1) {
+str::str(PyObject *p) : hash(-1), charcache(0), ascii(-1), cpindex(0) {
     // if(!PyBytes_Check(p))
     if(!PyUnicode_Check(p))
     // if(!PyString_Check(p))
@@ -723,11 +880,63 @@ str::str(PyObject *p) : hash(-1) {
     // unit = __GC_STRING(PyBytes_AS_STRING(p), PyBytes_Size(p));
 }
 
+/* extension APIs tend to pass the same few short strings (keys, names, enum values) back
+   and forth, so conversions of these go through two small direct-mapped caches. interned
+   Python strings map to the str they were converted to, and short strs map to the Python
+   string they were last converted to. entries hold a reference, so identity is stable, and
+   all access happens with the GIL held */
+
+#define __SS_STRCACHE 256
+#define __SS_STRCACHE_LEN 32
+
+struct __strcache_entry {
+    PyObject *p;
+    str *s;
+};
+
+static __strcache_entry __str_to_ss[__SS_STRCACHE], __str_to_py[__SS_STRCACHE];
+
+static inline size_t __strcache_slot(void *p) { return ((size_t)p >> 4) & (__SS_STRCACHE-1); }
+
+static void __strcache_set(__strcache_entry &e, PyObject *p, str *s) {
+    Py_INCREF(p);
+    Py_XDECREF(e.p);
+    e.p = p;
+    e.s = s;
+}
+
+template<> str *__to_ss(PyObject *p) {
+    if(p == Py_None)
+        return NULL;
+    if(!PyUnicode_Check(p) || !PyUnicode_CHECK_INTERNED(p))
+        return new str(p);
+    __strcache_entry &e = __str_to_ss[__strcache_slot(p)];
+    if(e.p == p)
+        return e.s;
+    str *s = new str(p);
+    __strcache_set(e, p, s);
+    if(s->unit.size() <= __SS_STRCACHE_LEN) /* and back to the same object */
+        __strcache_set(__str_to_py[__strcache_slot(s)], p, s);
+    return s;
+}
+
 PyObject *str::__to_py__() {
-//    return PyBytes_FromStringAndSize("bla", 3);
-    // return PyString_FromStringAndSize(c_str(), size());
-    // return PyBytes_FromStringAndSize(c_str(), size());
-    return PyUnicode_DecodeLatin1(c_str(), (Py_ssize_t)this->unit.size(), "");
+    size_t size = this->unit.size();
+    if(size <= __SS_STRCACHE_LEN) {
+        __strcache_entry &e = __str_to_py[__strcache_slot(this)];
+        if(e.s == this) {
+            Py_INCREF(e.p);
+            return e.p;
+        }
+    }
+    PyObject *p;
+    if(__is_ascii())
+        p = PyUnicode_DecodeLatin1(c_str(), (Py_ssize_t)size, "");
+    else
+        p = PyUnicode_DecodeUTF8(c_str(), (Py_ssize_t)size, "replace");
+    if(p && size <= __SS_STRCACHE_LEN)
+        __strcache_set(__str_to_py[__strcache_slot(this)], p, this);
+    return p;
 }
 #endif
 
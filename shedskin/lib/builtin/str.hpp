@@ -1,19 +1,93 @@
 /* Copyright 2005-2011 Mark Dufour and contributors; License Expat (See LICENSE) */
 
+/* UTF-8 helpers */
+
+static inline bool __ascii_only(const char *data, size_t size) { /* OR-reduction, vectorized by the compiler */
+    const uint64_t mask = 0x8080808080808080ULL;
+    uint64_t acc = 0, w[4];
+    size_t i = 0;
+    for(; i+32 <= size; i += 32) {
+        memcpy(w, data+i, 32);
+        if((w[0] | w[1] | w[2] | w[3]) & mask)
+            return false;
+    }
+    for(; i < size; i++)
+        acc |= (unsigned char)data[i];
+    return !(acc & 0x80);
+}
+
+static inline size_t __utf8_width(const char *data, size_t size, size_t pos) { /* invalid bytes count as one code point */
+    unsigned char c = (unsigned char)data[pos];
+    size_t w;
+    if(c < 0xc0)
+        return 1;
+    else if(c < 0xe0)
+        w = 2;
+    else if(c < 0xf0)
+        w = 3;
+    else if(c < 0xf8)
+        w = 4;
+    else
+        return 1;
+    for(size_t k=1; k<w; k++)
+        if(pos+k >= size or ((unsigned char)data[pos+k] & 0xc0) != 0x80)
+            return k;
+    return w;
+}
+
+static inline __ss_int __utf8_decode(const char *data, size_t w) {
+    const unsigned char *d = (const unsigned char *)data;
+    if(w == 1)
+        return d[0];
+    __ss_int c = d[0] & (0x7f >> w);
+    for(size_t k=1; k<w; k++)
+        c = (c << 6) | (d[k] & 0x3f);
+    return c;
+}
+
 /* str methods */
 
+inline bool str::__is_ascii() { /* threads computing it at the same time store the same value */
+    int a = ascii.load(std::memory_order_relaxed);
+    if(a == -1) {
+        a = __ascii_only(unit.data(), unit.size());
+        ascii.store(a, std::memory_order_relaxed);
+    }
+    return a;
+}
+
+inline __str_index *str::__index() {
+    __str_index *index = cpindex.load(std::memory_order_acquire);
+    if(!index)
+        index = __build_index();
+    return index;
+}
+
+inline str *str::__cp_at(size_t pos) {
+    size_t w = __utf8_width(unit.data(), unit.size(), pos);
+    if(w == 1)
+        return __char_cache[((unsigned char)(unit[pos]))];
+    return new str(unit.data()+pos, w);
+}
+
 inline str *str::__getitem__(__ss_int i) {
     i = __wrap(this, i);
-    return __char_cache[((unsigned char)(unit[(size_t)i]))];
+    if(__is_ascii())
+        return __char_cache[((unsigned char)(unit[(size_t)i]))];
+    return __cp_at(__byte_offset(i));
 }
 
 inline str *str::__getfast__(__ss_int i) {
     i = __wrap(this, i);
-    return __char_cache[((unsigned char)(unit[(size_t)i]))];
+    if(__is_ascii())
+        return __char_cache[((unsigned char)(unit[(size_t)i]))];
+    return __cp_at(__byte_offset(i));
 }
 
 inline __ss_int str::__len__() {
-    return (__ss_int)this->unit.size();
+    if(__is_ascii())
+        return (__ss_int)this->unit.size();
+    return __index()->length;
 }
 
 inline bool str::for_in_has_next(size_t i) {
@@ -21,7 +95,33 @@ inline bool str::for_in_has_next(size_t i) {
 }
 
 inline str *str::for_in_next(size_t &i) {
-    return __char_cache[((unsigned char)(unit[i++]))];
+    unsigned char c = (unsigned char)unit[i];
+    if(c < 0x80) {
+        i++;
+        return __char_cache[c];
+    }
+    str *s = __cp_at(i);
+    i += s->unit.size();
+    return s;
+}
+
+static inline str *__str_next(const char *&p, const char *end) {
+    unsigned char c = (unsigned char)*p;
+    if(c < 0x80) {
+        p++;
+        return __char_cache[c];
+    }
+    size_t w = __utf8_width(p, (size_t)(end-p), 0);
+    str *s = new str(p, w);
+    p += w;
+    return s;
+}
+
+template<class T> inline bool __split_assign(T &e, str *s) { /* leave loop variable untouched when done */
+    if(!s)
+        return false;
+    e = s;
+    return true;
 }
 
 template <class U> str *str::join(U *iter) {
@@ -31,24 +131,24 @@ template <class U> str *str::join(U *iter) {
     typename U::for_in_unit e;
     typename U::for_in_loop __3;
     U *__1;
-    __join_cache->units.resize(0);
+    __GC_VECTOR(str *) units; /* local, as join may run on several threads or re-enter */
     total = 0;
     FOR_IN(e,iter,1,2,3)
-        __join_cache->units.push_back(e);
+        units.push_back(e);
         sz = e->unit.size();
         if(sz != 1)
             only_ones = false;
         total += sz;
     END_FOR
     size_t unitsize = this->unit.size();
-    size_t elems = __join_cache->units.size();
+    size_t elems = units.size();
     if(elems==1)
-        return __join_cache->units[0];
+        return units[0];
     str *s = new str();
     if(unitsize == 0 and only_ones) {
         s->unit.resize(total);
         for(size_t j=0; j<elems; j++)
-            s->unit[j] = __join_cache->units[j]->unit[0];
+            s->unit[j] = units[j]->unit[0];
     }
     else if(elems) {
         total += (elems-1)*unitsize;
@@ -56,7 +156,7 @@ template <class U> str *str::join(U *iter) {
         size_t tsz;
         size_t k = 0;
         for(size_t m = 0; m<elems; m++) {
-            str *t = __join_cache->units[m];
+            str *t = units[m];
             tsz = t->unit.size();
             if (tsz == 1)
                 s->unit[k] = t->unit[0];
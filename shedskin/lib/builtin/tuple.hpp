@@ -39,10 +39,11 @@ template<class T> tuple2<T, T>::tuple2(tuple2<T, T> *p) {
 
 template<class T> tuple2<T, T>::tuple2(str *s) {
     this->__class__ = cl_tuple;
-    this->units.resize(len(s));
-    size_t sz = s->unit.size();
+    size_t sz = (size_t)len(s);
+    this->units.resize(sz);
+    size_t pos = 0;
     for(size_t i=0; i<sz; i++)
-        this->units[i] = __char_cache[((unsigned char)(s->unit[i]))];
+        this->units[i] = s->for_in_next(pos);
 }
 
 template<class T> T tuple2<T, T>::__getfirst__() {
@@ -119,15 +120,11 @@ template<class T> __ss_bool tuple2<T, T>::__contains__(T a) {
 }
 
 template<class T> __ss_bool tuple2<T, T>::__eq__(pyobj *p) {
-    tuple2<T,T> *b;
-    b = (tuple2<T,T> *)p;
-    size_t sz = this->units.size();
-    if(b->units.size() != sz)
-        return False;
-    for(size_t i=0; i<sz; i++)
-        if(!__eq(this->units[i], b->units[i]))
-            return False;
-    return True;
+    return __eq(this, (tuple2<T,T> *)p);
+}
+
+template<class T> __ss_int tuple2<T, T>::__cmp__(pyobj *p) {
+    return __cmp(this, (tuple2<T,T> *)p);
 }
 
 template<class T> tuple2<T,T> *tuple2<T, T>::__slice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s) {
@@ -146,11 +143,7 @@ template<class T> tuple2<T,T> *tuple2<T, T>::__slice__(__ss_int x, __ss_int l, _
 }
 
 template<class T> long tuple2<T, T>::__hash__() {
-    long seed = 0;
-    size_t sz = this->units.size();
-    for(size_t i = 0; i<sz; i++)
-        seed = hash_combine(seed, hasher<T>(this->units[i]));
-    return seed;
+    return hasher(this);
 }
 
 template<class T> tuple2<T,T> *tuple2<T,T>::__copy__() {
@@ -226,22 +219,15 @@ template<class A, class B> __ss_int tuple2<A, B>::__len__() {
 }
 
 template<class A, class B> __ss_bool tuple2<A, B>::__eq__(pyobj *p) {
-    tuple2<A,B> *b = (tuple2<A,B> *)p;
-    return __mbool(__eq(first, b->__getfirst__()) & __eq(second, b->__getsecond__()));
+    return __eq(this, (tuple2<A,B> *)p);
 }
 
 template<class A, class B> __ss_int tuple2<A, B>::__cmp__(pyobj *p) {
-    if (!p) return 1;
-    tuple2<A,B> *b = (tuple2<A,B> *)p;
-    if(int c = __cmp(first, b->first)) return c;
-    return __cmp(second, b->second);
+    return __cmp(this, (tuple2<A,B> *)p);
 }
 
 template<class A, class B> long tuple2<A, B>::__hash__() {
-    long seed = 0;
-    seed = hash_combine(seed, hasher<A>(first));
-    seed = hash_combine(seed, hasher<B>(second));
-    return seed;
+    return hasher(this);
 }
 
 template<class A, class B> str *tuple2<A, B>::__repr__() {
@@ -20,6 +20,10 @@ void *disable() {
     return NULL;
 }
 
+__ss_bool isenabled() {
+    return __mbool(!GC_is_disabled());
+}
+
 void *collect() {
     GC_gcollect();
 
@@ -14,6 +14,8 @@ void *enable();
 
 void *disable();
 
+__ss_bool isenabled();
+
 void *collect();
 
 } // module namespace
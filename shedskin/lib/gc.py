@@ -6,5 +6,8 @@ def enable():
 def disable():
     pass
 
+def isenabled():
+    return True
+
 def collect():
     pass
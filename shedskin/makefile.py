@@ -12,6 +12,8 @@ import subprocess
 import sys
 import sysconfig
 
+from . import python
+
 
 def check_output(cmd: str):
     try:
@@ -139,6 +141,8 @@ def generate_makefile(gx):
                 line += " -D__SS_BACKTRACE -rdynamic -fno-inline"
             if gx.nogc:
                 line += " -D__SS_NOGC"
+            if python.gc_threads(gx):
+                line += " -pthread -DGC_THREADS"
             if gx.pyextension_product:
                 if sys.platform == "win32":
                     line += " -I%s\\include -D__SS_BIND" % prefix
@@ -172,6 +176,8 @@ def generate_makefile(gx):
                     line += " -lutil"
             if "hashlib" in (m.ident for m in modules):
                 line += " -lcrypto"
+            if python.gc_threads(gx):
+                line += " -pthread"
 
         write(line)
     write()
@@ -7,6 +7,7 @@ Copyright 2005-2023 Mark Dufour and contributors; License GNU GPL version 3 (See
 import ast
 import collections
 import importlib.util
+import linecache
 import os
 import re
 import sys
@@ -323,6 +324,43 @@ def parse_file(name: str):
         sys.exit(1)
 
 
+def directives(mv: 'graph.ModuleVisitor', node) -> set[str]:
+    """words after '# shedskin:' on the first line of a class, function or loop statement"""
+    if not hasattr(node, "lineno"):  # generated during analysis
+        return set()
+    line = linecache.getline(str(mv.module.filename), node.lineno)
+    m = re.search(r"#\s*shedskin:\s*(.*)$", line)
+    if not m:
+        return set()
+    return set(m.group(1).replace(",", " ").split())
+
+
+def class_directives(cl: Class) -> set[str]:
+    return directives(cl.mv, cl.node)
+
+
+def function_directives(func: Function) -> set[str]:
+    if not func.node or not func.mv:
+        return set()
+    return directives(func.mv, func.node)
+
+
+def gc_threads(gx: 'config.GlobalInfo') -> bool:
+    """may compiled code run on several threads (--parallel, --nogil or '# shedskin: nogil'),
+    so that the GC must be built with thread support"""
+    if gx.parallel or gx.nogil:
+        return True
+    if gx.pyextension_product:
+        for module in gx.modules.values():
+            if not module.builtin:
+                funcs = list(module.mv.funcs.values())
+                for cl in module.mv.classes.values():
+                    funcs.extend(cl.funcs.values())
+                if any("nogil" in function_directives(func) for func in funcs):
+                    return True
+    return False
+
+
 def find_module(gx: 'config.GlobalInfo', name: str, paths):
     if "." in name:
         name, module_name = name.rsplit(".", 1)
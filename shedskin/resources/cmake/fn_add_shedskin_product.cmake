@@ -114,6 +114,12 @@ function(add_shedskin_product)
         set(opts)
     endif()
 
+    # threaded code needs a thread-enabled Boehm GC
+    if("${opts}" MATCHES "--parallel|--nogil")
+        list(APPEND SHEDSKIN_COMPILE_OPTIONS "-pthread" "-DGC_THREADS")
+        list(APPEND SHEDSKIN_LINK_OPTIONS "-pthread")
+    endif()
+
     if(SIMPLE_PROJECT)
         set(PROJECT_EXE_DIR ${PROJECT_BINARY_DIR}/exe)
         set(PROJECT_EXT_DIR ${PROJECT_BINARY_DIR}/ext)
@@ -271,6 +271,8 @@ def test_range():  # TODO __slice__
     assert list(range(10, 1, -a)) == [10, 9, 8, 7, 6, 5, 4, 3, 2]
 
     assert len(range(5)) == 5
+    assert len(range(-1073741824, 1073741824, 4)) == 536870912
+    assert len(range(1073741824, -1073741824, -3)) == 715827883
     assert max(range(10)) == 9
     assert min(range(10)) == 0
     assert list(range(3)) == [0, 1, 2]
@@ -1,3 +1,6 @@
+import copy
+
+
 class Person:
     a = 1
 
@@ -160,12 +163,38 @@ def test_instance_str():
     assert len(e) == 2
 
 
+class Particle:  # shedskin: soa
+    def __init__(self, x, y):
+        self.x, self.y = x, y
+        self.vx, self.vy = 1.0, -1.0
+        self.tags = ['p']
+
+
+def test_class_soa():
+    ps = [Particle(float(i), 2.0 * i) for i in range(1000)]
+    for step in range(3):
+        for p in ps:
+            p.x += p.vx
+            p.y += p.vy
+    assert ps[10].x == 13.0 and ps[10].y == 17.0
+    assert sum(p.x for p in ps) == 502500.0
+    q = ps[500]
+    ps = None
+    assert q.x == 503.0
+    r = copy.copy(q)
+    r.x = 0.0
+    r.tags.append('q')
+    assert q.x == 503.0 and q.tags == ['p', 'q']
+    assert r is not q and q is q
+
+
 def test_all():
     test_class_person()
     test_class_edge()
     test_class_attrs()
     test_class_instance_attrs()
     test_instance_str()
+    test_class_soa()
 
 
 
@@ -69,6 +69,42 @@ def test_for_else():
     assert xs == [1, 1, 1, 1, 1, 1, 2]
 
 
+def grow(xs):
+    xs.append(len(xs))
+
+
+def test_for_seq():
+    xs = [1, 2, 3]
+    total = 0
+    for x in xs:
+        total += x * 2
+    assert total == 12
+
+    for x in xs:
+        if x < 3:
+            xs.append(x + 10)
+    assert xs == [1, 2, 3, 11, 12]
+
+    ys = [4, 5]
+    for y in ys:
+        if len(ys) < 4:
+            grow(ys)
+    assert ys == [4, 5, 2, 3]
+
+    cps = []
+    for c in 'a\xe9\u20acx':
+        cps.append(ord(c))
+    assert cps == [97, 233, 8364, 120]
+
+    b = bytearray(b'ab')
+    for v in b:
+        if v == 97:
+            b.extend(b'z')
+    assert b == bytearray(b'abz')
+
+    fs = [v * 2 for v in (1.5, 2.5)]
+    assert fs == [3.0, 5.0]
+
 
 def test_all():
     test_for_range()
@@ -79,6 +115,7 @@ def test_all():
     test_for_break()
     test_for_continue()
     test_for_else()
+    test_for_seq()
 
 if __name__ == '__main__':
     test_all() 
@@ -25,9 +25,37 @@ def test_if_else_expr():
     assert 8 + (2 if 1 else 3) == 10
     assert 8 + (2 if 0 else 3) == 11
 
+def method(m):
+    if m == 'GET':
+        return 1
+    elif m == 'POST':
+        return 2
+    elif 'HEAD' == m:
+        return 3
+    elif m != 'PUT':
+        return 4
+    return 5
+
+def test_if_elif_literals():
+    assert [method(m) for m in ['GET', 'POST', 'HEAD', 'PUT', 'GE', '', 'één']] == [1, 2, 3, 5, 4, 4, 4]
+    m = None
+    if m == 'GET':
+        m = 'x'
+    assert m is None
+
+def test_in_literals():
+    words = ['GET', 'PUT', 'POST', 'get', '', 'één']
+    assert [w in ('GET', 'PUT', 'POST', 'één') for w in words] == [True, True, True, False, False, True]
+    assert [w not in ['PUT', ''] for w in words] == [True, False, True, True, False, True]
+    assert [w in {'get', 'GET'} for w in words] == [True, False, False, True, False, False]
+    assert [i for i in range(-3, 70) if i in (1, 2, 5, 9, 63)] == [1, 2, 5, 9, 63]
+    assert [i for i in range(-3, 10) if i not in [4, 2, 3, 5]] == [-3, -2, -1, 0, 1, 6, 7, 8, 9]
+
 def test_all():
     test_if_else_expr()
     test_if_elif_else()
+    test_if_elif_literals()
+    test_in_literals()
 
 if __name__ == '__main__':
     test_all() 
@@ -0,0 +1,95 @@
+# built with --parallel, and run with SHEDSKIN_THREADS=4
+
+
+def dashed(i):
+    return '-'.join((str(i), str(i + 1), str(i + 2)))
+
+
+def dotted(i):
+    return b'.'.join((b'a', b'xyz'[i % 3:]))
+
+
+def square(x):
+    return x * x
+
+
+def char_at(s, i):
+    return s[i]
+
+
+def shout(i):
+    print('shout', i)
+    return i
+
+
+def test_parallel_comprehension():
+    assert [dashed(i) for i in range(50000)] == ['%d-%d-%d' % (i, i + 1, i + 2) for i in range(50000)]
+    assert [dotted(i) for i in range(50000)] == [b'a.' + b'xyz'[i % 3:] for i in range(50000)]
+    xs = [float(i) for i in range(50000)]
+    assert [square(x) for x in xs] == [x * x for x in xs]
+    assert [shout(i) for i in range(3)] == [0, 1, 2]
+    text = 'aé€😀' * 5000  # code point index built by whichever thread comes first
+    assert [char_at(text, i) for i in range(20000)] == ['a', 'é', '€', '😀'] * 5000
+
+
+def test_parallel_loop():
+    n = 20000
+    squares = [0] * n
+    for i in range(n):  # shedskin: parallel
+        squares[i] = square(i)
+    assert squares == [i * i for i in range(n)]
+
+    total = 0
+    for i in range(n):  # shedskin: parallel
+        total += squares[i] % 7
+    assert total == sum(i * i % 7 for i in range(n))
+
+    # rejected, and run serially: dict slots, resizing lists
+    d = {}
+    for i in range(n):  # shedskin: parallel
+        d[i] = square(i)
+    assert len(d) == n and d[n - 1] == (n - 1) * (n - 1)
+
+    a = []
+    for i in range(n):  # shedskin: parallel
+        a.append(i)
+    assert a == list(range(n))
+
+    b = list(range(n))
+    for i in range(100):  # shedskin: parallel
+        b[i:i + 1] = [i, i]
+    assert len(b) == n + 100
+
+    c = list(range(n))
+    for i in range(100):  # shedskin: parallel
+        del c[i]
+    assert len(c) == n - 100 and c[:3] == [1, 3, 5]
+
+    last = 0
+    for i in range(n):  # shedskin: parallel
+        last = squares[i]
+    assert last == (n - 1) * (n - 1)
+
+    # rejected: v is not assigned on every path, e and f are the same list
+    out = [0] * n
+    v = 0
+    for i in range(n):  # shedskin: parallel
+        if i % 100 == 0:
+            v = square(i)
+        out[i] = v
+    assert out == [i // 100 * 100 * (i // 100 * 100) for i in range(n)]
+
+    e = list(range(n))
+    f = e
+    for i in range(n - 1):  # shedskin: parallel
+        e[i] = f[i + 1]
+    assert e == list(range(1, n)) + [n - 1]
+
+
+def test_all():
+    test_parallel_comprehension()
+    test_parallel_loop()
+
+
+if __name__ == '__main__':
+    test_all()
@@ -37,6 +37,24 @@ def test_key_error():
     assert error
 
 
+def test_key_error_message():
+    try:
+        {'a': 1}['zz']
+    except KeyError as e:
+        assert str(e) == "'zz'"
+    try:
+        {1, 2}.remove(5)
+    except KeyError as e:
+        assert str(e) == '5'
+    it = iter([1])
+    next(it)
+    for i in range(2):
+        try:
+            next(it)
+        except StopIteration as e:
+            assert str(e) == ''
+
+
 def test_assert_error():
     error = False
     try:
@@ -100,6 +118,51 @@ def test_index_error():
         error = True
     assert error
 
+def test_lookup_lowering():
+    d = {'a': 1}
+    total = 0
+    for k in ['a', 'b', 'a']:
+        try:
+            v = d[k]
+        except KeyError:
+            v = -1
+        else:
+            total += 100
+        total += v
+    assert total == 201
+
+    xs = [1, 2, 3]
+    found = []
+    for i in [0, -1, 3, -4]:
+        try:
+            x = xs[i]
+        except IndexError:
+            x = 0
+        found.append(x)
+    assert found == [1, 3, 0, 0]
+
+    n = 5
+    try:
+        n = int('x')
+    except ValueError:
+        pass
+    assert n == 5
+    try:
+        n = int(' 7 ')
+    except ValueError:
+        n = 0
+    assert n == 7
+
+    pairs = {(1, 2): 'x'}
+    hits = []
+    for a in range(3):
+        try:
+            y = pairs[a, 2]
+        except LookupError:
+            continue
+        hits.append(y)
+    assert hits == ['x']
+
 def test_system_exit_error():
     error = False
     try:
@@ -148,9 +211,11 @@ def test_system_exit_error():
 
 def test_all():
     test_key_error()
+    test_key_error_message()
     # test_type_error() # cpp translated code will not compile :-)
     test_assert_error()
     test_index_error()
+    test_lookup_lowering()
     # test_my_error()
     test_value_error()
     test_os_error()
@@ -3,11 +3,11 @@ import gc
 
 def test_gc():
     gc.enable()
-    # assert gc.isenabled()
+    assert gc.isenabled()
     gc.collect()
     gc.disable()
-    # assert not gc.isenabled() ## not implemented
-    assert True ## FIXME hack
+    assert not gc.isenabled()
+    gc.enable()
 
 def test_all():
     test_gc()
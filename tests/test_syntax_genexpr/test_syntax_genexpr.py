@@ -1,15 +1,104 @@
 
 
+def count_up(n, step=1):
+    i = 0
+    while i < n:
+        yield i
+        i += step
+
+def signed(xs):
+    for x in xs:
+        if x % 2:
+            yield x, x * x
+        else:
+            yield x, -x
+
+def evens(n):
+    for v in count_up(n):
+        if v % 2 == 0:
+            yield v
+
+def first_square_above(n):
+    for k in count_up(100):
+        if k * k > n:
+            return k
+    return -1
+
 def test_sum():
     xs = range(10)
     ys = range(10, 20)
     assert sum(x+y for x,y in zip(xs,ys)) == 190
 
+def test_reduce():
+    xs = [3, 1, 4, 1, 5, 9, 2, 6]
+    words = ['a', 'bb', 'ccc']
+    assert sum(x * 2 for x in xs if x > 2) == 54
+    assert sum(f / 2 for f in [1.0, 2.5]) == 1.75
+    assert sum(x > 2 for x in xs) == 5
+    assert sum([x + 1 for x in xs]) == 39
+    assert any(x > 8 for x in xs) and not any(x > 9 for x in xs)
+    assert all(x > 0 for x in xs) and not all(x > 1 for x in xs)
+    assert max(x % 5 for x in xs) == 4 and min(x % 5 for x in xs) == 0
+    assert max(w for w in words) == 'ccc' and min([w for w in words]) == 'a'
+    assert '-'.join(w.upper() for w in words) == 'A-BB-CCC'
+    assert ''.join(w for w in words if len(w) > 3) == ''
+    assert sum(x * y for x in range(3) for y in range(4)) == 18
+    try:
+        max(x for x in xs if x > 100)
+        assert False
+    except ValueError:
+        pass
+
+def test_for():
+    i = 'unchanged'
+    total = 0
+    for k in count_up(5):
+        total += k
+    assert (total, i) == (10, 'unchanged')
+
+    assert [(a, b) for a, b in signed([1, 2, 3])] == [(1, 1), (2, -2), (3, 9)]
+    result = []
+    for a, b in signed([1, 2, 3]):
+        result.append(a + b)
+    assert result == [2, 0, 12]
+
+    nested = []
+    for a in count_up(3):
+        for b in count_up(a):
+            nested.append((a, b))
+    assert nested == [(1, 0), (2, 0), (2, 1)]
+
+    result = []
+    for k in count_up(10, 3):
+        if k == 3:
+            continue
+        result.append(k)
+    else:
+        result.append(-1)
+    assert result == [0, 6, 9, -1]
+
+    assert [v for v in evens(7)] == [0, 2, 4, 6]
+    assert first_square_above(50) == 8
+
+    result = []
+    for x in (y * 2 for y in range(4) if y != 2):
+        result.append(x)
+    for x in (y + z for y in range(3) for z in range(2)):
+        result.append(x)
+    assert result == [0, 2, 6, 0, 1, 1, 2, 2, 3]
+    for x in (y for y in range(3)):
+        if x == 1:
+            break
+    else:
+        assert False
+
 def test_list():
     assert list(i for i in range(2)) == [0,1]
 
 def test_all():
     test_sum()
+    test_reduce()
+    test_for()
     test_list()
 
 
@@ -109,6 +109,9 @@ def test_bytearray_insert():
     assert ba == bytearray(b'bula')
     ba.insert(-2, ord('w'))
     assert ba == bytearray(b'buwla')
+    ba.insert(100, ord('x'))
+    ba.insert(-100, ord('y'))
+    assert ba == bytearray(b'ybuwlax')
 
 # def test_bytearray_hash():
 #     try:
@@ -125,6 +128,34 @@ def test_bytearray_slice():
     assert ba == bytearray(b'bblaabla')
     del ba[::2]
     assert ba == bytearray(b'baba')
+    ba[3:1] = BLA
+    assert ba == bytearray(b'babblaa')
+    ba[:] = ba
+    assert ba == bytearray(b'babblaa')
+    del ba[:3]
+    assert ba == bytearray(b'blaa')
+
+def test_bytearray_buffer():
+    buf = bytearray()
+    buf += b'GET / HTTP/1.1\r\nHost: x\r\n\r\nbody'
+    lines = []
+    while True:
+        i = buf.find(b'\r\n')
+        if i == -1:
+            break
+        lines.append(bytes(buf[:i]))
+        del buf[:i+2]
+    assert lines == [b'GET / HTTP/1.1', b'Host: x', b'']
+    assert buf == bytearray(b'body')
+    assert buf.find(b'', 10) == -1
+    assert buf.rfind(b'o', 0, 2) == 1
+
+def test_bytes_addition_assign():
+    a = b'bla'
+    b = a
+    b += b'h'
+    assert a == b'bla'
+    assert b == b'blah'
 
 def test_bytearray_misc():
     assert bytearray() == bytearray(b'')
@@ -154,6 +185,8 @@ def test_all():
     test_bytearray_insert()
     # test_bytearray_hash()
     test_bytearray_slice()
+    test_bytearray_buffer()
+    test_bytes_addition_assign()
     test_bytearray_misc()
 
 if __name__ == "__main__":
@@ -84,6 +84,23 @@ def test_items():
     assert sorted(dict(["ab", "cd"]).items()) ==  [('a', 'b'), ('c', 'd')]
     assert sorted(dict(set([(1, 2.0), (3, 4.0)])).items()) == [(1, 2.0), (3, 4.0)]
 
+    f = {'b': 2, 'a': 3, 'c': 1}
+    assert sorted(f.items(), key=lambda kv: kv[1]) == [('c', 1), ('b', 2), ('a', 3)]
+    assert sorted(f.items(), reverse=True)[0] == ('c', 1)
+    assert max(f.items()) == ('c', 1)
+    assert min(f.items()) == ('a', 3)
+    assert max(f.items(), key=lambda kv: kv[1]) == ('a', 3)
+    assert sorted(list(f.items())) == [('a', 3), ('b', 2), ('c', 1)]
+    assert sorted(list(f.values())) == [1, 2, 3]
+    assert sum(v for k, v in f.items()) == 6
+    assert list({}.values()) == []
+    try:
+        min(dict([(1, 2)] * 0).items())
+    except ValueError:
+        pass
+    else:
+        assert False
+
 # def test_func_as_value(): ## FIXME: does not work
     # g = {}
     # g['f1'] = add1
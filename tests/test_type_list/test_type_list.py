@@ -33,6 +33,28 @@ def test_list_comp():
     assert [i for i in hu(10)] == [1]
     assert [((v, u), w) for u, (v, w) in [d]] == [((1.1, 1), 'u')]
 
+def double(y):
+    return y * 2
+
+def logged(log, x):
+    log.append(x)
+    return x
+
+def test_list_fusion():
+    ys = [1, 2, 3, 4]
+    assert [x + 1 for x in [double(y) for y in ys]] == [3, 5, 7, 9]
+    assert [x + 1 for x in (double(y) for y in ys)] == [3, 5, 7, 9]
+    assert [x for x in [double(y) for y in ys if y % 2] if x > 2] == [6]
+    assert [a + b for a, b in [(y, y * y) for y in ys]] == [2, 6, 12, 20]
+    assert [w.upper() for w in [s.strip() for s in [' a ', 'b ']]] == ['A', 'B']
+    assert [t * 2 for y in ys for t in [y + 1]] == [4, 6, 8, 10]
+    assert [x * 2 for x in range(len(ys))] == [0, 2, 4, 6]
+    assert [x for x in range(10, 0, -3)] == [10, 7, 4, 1]
+
+    log = []
+    assert [logged(log, -x) for x in [logged(log, y) for y in ys[:2]]] == [-1, -2]
+    assert log == [1, 2, -1, -2]
+
 def test_list_nested():
     q = [[[1],[2]],[[3],[4]]]
 
@@ -106,6 +128,28 @@ def test_list_append():
     e.append([1])
     assert e[0] == [1]
 
+def test_list_small():
+    a = [1, 2]
+    b = a
+    for i in range(3, 7):
+        a.append(i)
+    assert b == [1, 2, 3, 4, 5, 6]
+    a.insert(0, 0)
+    a[1:3] = [9]
+    assert a == [0, 9, 3, 4, 5, 6]
+    del a[2:]
+    assert a == [0, 9] and len(a) == 2
+    a.extend(a)
+    assert a == [0, 9, 0, 9]
+    c = a[:]
+    a.reverse()
+    assert c == [0, 9, 0, 9] and a == [9, 0, 9, 0]
+    assert sorted(a) == [0, 0, 9, 9]
+    d = [[i] for i in range(5)]
+    d.pop(0)
+    assert d == [[1], [2], [3], [4]]
+    assert (1, 2, 3, 4, 5) + (6,) == (1, 2, 3, 4, 5, 6)
+
 def test_tuple_in_list():
     list4 = [(1,2),(3,4)]
     assert (1,2) in list4
@@ -147,12 +191,14 @@ def test_all():
     test_list_cmp()
     test_list_comp()
     test_list_del()
+    test_list_fusion()
     test_list_index1()
     test_list_index2()
     test_list_length()
     test_list_misc()
     test_list_nested()
     test_list_slice()
+    test_list_small()
     test_list_subsets()
     test_tuple_in_list()
 
@@ -34,7 +34,44 @@ def test_find():
     assert 'bla'.find('la') == 1
     assert 'bla'.find('ba') == -1
 
-def test_format(): pass
+class ManyFormats:
+    def __str__(self):  # evicts the format cache while the caller is formatting
+        s = ''
+        for i in range(1500):
+            s = ('{}-' + str(i) + '-{}').format(i, len(s))
+        return s
+
+def test_format():
+    x = 3.14159
+    n = -1234567
+    assert '{} {} {}'.format(x, n, 'ab') == '3.14159 -1234567 ab'
+    assert '{:>10.3f}|{:<9}|{:^7}|{:*^7}'.format(x, n, 'ab', 'ab') == '     3.142|-1234567 |  ab   |**ab***'
+    assert '{1}{0}{1}'.format('a', 'b') == 'bab'
+    assert '{:,} {:_x} {:#x} {:#o} {:#b} {:X}'.format(n, 255*65536, 255, 8, 5, 255) == '-1,234,567 ff_0000 0xff 0o10 0b101 FF'
+    assert '{:+d} {: d} {:08d} {:08.2f}'.format(42, 42, n, -x) == '+42  42 -1234567 -0003.14'
+    assert '{:e} {:.3E} {:g} {:.1%}'.format(12345.678, 0.00012, 1e20, 0.256) == '1.234568e+04 1.200E-04 1e+20 25.6%'
+    assert '{!r} {!s:>4}'.format('ab', 'ab') == "'ab'   ab"
+    assert '{:.2}|{:5}|{}'.format('abcdef', True, False) == 'ab|    1|False'
+    assert '{:c}{{}}{:,.2f}'.format(233, 1234567.891) == 'é{}1,234,567.89'
+    assert '{:^7}|{:.3}'.format('één', 1.0) == '  één  |1.0'
+
+    fmt = '{:>6.2f}|{}'
+    assert [fmt.format(v, 'x') for v in [1.5, -3.0]] == ['  1.50|x', ' -3.00|x']
+    fmt = '{1}-{0!r}'
+    assert fmt.format('a', 'b') == "b-'a'"
+    fmt = '{!a}|{!a:>12}'
+    assert fmt.format('é€😀', 'aä') == "'\\xe9\\u20ac\\U0001f600'|     'a\\xe4'"
+    assert f'{"é€😀"!a}' == "'\\xe9\\u20ac\\U0001f600'"
+    fmt = '<{}|{}>'
+    assert fmt.format(ManyFormats(), 7) == '<1499-1499-12|7>'
+    try:
+        fmt.format('a')
+        assert False
+    except IndexError:
+        pass
+
+    w = 8
+    assert f'{x:.2f}|{n:>{w}}|{"ab"!r}|{255:#06x}|{3:03}' == "3.14|-1234567|'ab'|0x00ff|003"
 
 def test_format_map(): pass
 
@@ -177,10 +214,30 @@ def test_split():
     s = 'hop  hap  hup hup  woef '
     assert s.split('  ', maxsplit=2) == ['hop', 'hap', 'hup hup  woef ']
 
+    # lazy splitting in loops
+    fields = []
+    for f in 'a,b,,c,'.split(','):
+        fields.append(f)
+    assert fields == ['a', 'b', '', 'c', '']
+    words = []
+    for w in '  x  y z '.split(None, 1):
+        words.append(w)
+    assert words == ['x', 'y z ']
+    assert [int(x) for x in '1 2 3'.split()] == [1, 2, 3]
+    assert sum(len(w) for w in 'aa-bbb-c'.split('-', 1)) == 7
+    for w in 'hop hap'.split():
+        pass
+    assert w == 'hap'
+
 def test_splitlines():
     assert "ab\ncd\r\nef\rghi\n".splitlines() == ['ab', 'cd', 'ef', 'ghi']
     assert "ab\ncd\r\nef\rghi\n".splitlines(1) == ['ab\n', 'cd\r\n', 'ef\r', 'ghi\n']
 
+    lines = []
+    for l in "ab\ncd\r\nef\rghi".splitlines(True):
+        lines.append(l)
+    assert lines == ['ab\n', 'cd\r\n', 'ef\r', 'ghi']
+
 def test_startswith():
     assert 'bla'.startswith('bla')
     assert not 'bla'.startswith('xx')
@@ -291,6 +348,35 @@ def test_special_characters():
     assert uni_pieces['k'] == "♔"
     assert ss == '量子力学'
 
+def test_unicode_indexing():
+    s = "héllo wörld"
+    assert len(s) == 11
+    assert s[1] == "é"
+    assert s[-4] == "ö"
+    assert s[1:4] == "éll"
+    assert s[::-1] == "dlröw olléh"
+    assert s[::3] == "hlwl"
+    assert [c for c in "aé量"] == ["a", "é", "量"]
+    assert list("aé量") == ["a", "é", "量"]
+    assert s.find("w") == 6
+    assert s.find("ö", 2, 9) == 7
+    assert s.rfind("l") == 9
+    assert s.count("l", 3) == 2
+    assert s.startswith("ll", 2)
+    assert s.endswith("wö", 0, 8)
+    assert "量子".center(6, "*") == "**量子**"
+    assert "é".rjust(3) == "  é"
+    assert ord("量") == 37327
+    assert chr(233) == "é"
+    assert chr(ord("♔")) == "♔"
+    assert repr("aé") == "'aé'"
+    long = "ü" * 200 + "x"
+    assert len(long) == 201
+    assert long[200] == "x"
+    assert long[130:133] == "üüü"
+    assert long.find("x") == 200
+    assert "abc".isascii() and not long.isascii()
+
 def test_str_id():
     foo_a = "foo"
     foo_b = "foo"
@@ -350,6 +436,7 @@ def test_all():
     test_upper()
     test_zfill()
     test_special_characters()
+    test_unicode_indexing()
     test_str_id()
 
 
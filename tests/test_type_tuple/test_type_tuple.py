@@ -80,6 +80,24 @@ def test_mul():
     assert d == (1, 2, 1, 2)
 
 
+def test_compare_hash():
+    pts = [(3, 'c'), (1, 'z'), (1, 'a'), (2, 'b')]
+    pts.sort()
+    assert pts == [(1, 'a'), (1, 'z'), (2, 'b'), (3, 'c')]
+    assert (1, 2) < (1, 3) and (1, 2, 3) > (1, 2) and (2, 1) >= (1, 5)
+    assert min([(1, 2, 3), (1, 2)]) == (1, 2)
+    assert (1, 2) != (1, 2, 0) and ('a', 1) != ('a', 2)
+
+    grid = {}
+    for x in range(20):
+        for y in range(20):
+            grid[x, y] = x * y
+    assert len(grid) == 400 and grid[3, 4] == 12
+    assert (19, 19) in grid and (20, 0) not in grid
+    assert hash((1, 'a')) == hash((1, 'a'))
+    assert {((1, 2), 'x'): 1}[(1, 2), 'x'] == 1
+
+
 def test_all():
     test_tuple()
     test_equivalence()
@@ -89,6 +107,7 @@ def test_all():
     test_iteration()
     test_add()
     test_mul()
+    test_compare_hash()
 
 
 